@@ -0,0 +1,232 @@
+// Durable bank: the transaction engine together with its write-ahead log and
+// snapshots. Shared by the GUI and the headless tools (BankingTool.cpp);
+// no raylib dependency.
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BankingEngine.h"
+#include "BankingLedgerFile.h"
+
+// ---------- Records ----------
+inline WalRecord MakeRecord(WalOp op, int account, int counterparty = 0, Money amount = Money(),
+                            time_t when = time(nullptr)) {
+    WalRecord r;
+    r.op = op;
+    r.time = (int64_t)when;
+    r.account = account;
+    r.counterparty = counterparty;
+    r.amount = amount.minor;
+    return r;
+}
+
+// ---------- Snapshots ----------
+// A snapshot is a chain of ledger segments (BankingLedgerFile.h), each named
+// after the LSN it covers, <base>.ledger.<lsn>; the write-ahead log's
+// snapshot blob only records the newest one's LSN and directory checksum.
+struct SnapshotRef {
+    uint64_t lsn;
+    uint32_t crc;
+    uint32_t pad;
+};
+
+// Call under engine.Quiesce(): copies what the next segment needs, i.e. the
+// accounts from slot `firstNew` on and the in-memory rows of the others.
+inline std::vector<LedgerCutEntry> CaptureAccounts(const TransactionEngine& engine, size_t firstNew) {
+    std::vector<LedgerCutEntry> cut;
+    for (size_t i = 0; i < engine.Size(); ++i) {
+        const Customer& c = engine.At(i);
+        const Ledger& h = c.account.history;
+        if (i < firstNew && h.Size() == h.BaseSize()) continue;
+        cut.push_back(LedgerCutEntry{i, c.id, c.name, c.account.balance, {}});
+        h.CopyTail(cut.back().tail);
+    }
+    return cut;
+}
+
+// Replaces the engine's contents with the segments' accounts, oldest segment
+// first; their histories read from the mappings. Leaves the engine empty if
+// a segment is damaged.
+inline bool LoadAccounts(TransactionEngine& engine, const std::vector<std::shared_ptr<LedgerFile>>& files) {
+    engine.Clear();
+    for (const auto& file : files) {
+        for (size_t i = 0; i < file->Accounts(); ++i) {
+            const LedgerAccountEntry& e = file->Account(i);
+            int slot = engine.IndexOf(e.id);
+            Customer* c = slot == -1 ? engine.Restore(e.id, e.name) : &engine.At((size_t)slot);
+            if (!c) { engine.Clear(); return false; }
+            c->account.balance = Money::FromMinor(e.balance);
+            c->account.history.Attach(file->Rows(e), (size_t)e.count);
+        }
+    }
+    if (files.empty() || engine.NextId() == files.back()->NextId()) return true;   // none: an empty bank
+    engine.Clear();
+    return false;
+}
+
+// ---------- Bank ----------
+// Open() maps the last snapshot's ledger segments, replays the newer log records
+// and then journals every applied operation. The log's commit thread makes an
+// operation durable a few milliseconds after Commit() returns; callers
+// never wait on disk unless they Flush().
+class Bank {
+public:
+    struct Recovery {
+        bool fromSnapshot = false;
+        size_t replayed = 0;        // logged operations applied on top
+        bool persistent = false;    // false: the log could not be opened
+    };
+
+    size_t snapshotInterval = 10000;   // logged records between snapshots
+
+    // Files are <base>.snap, <base>.wal.N and <base>.ledger.<lsn> in the
+    // working directory.
+    explicit Bank(std::string base = "bank") : base(base), wal(base) {}
+    ~Bank() { Close(); }
+
+    Bank(const Bank&) = delete;
+    Bank& operator=(const Bank&) = delete;
+
+    Recovery Open() {
+        Recovery rec;
+        std::string blob, msg;
+        SnapshotRef ref;
+        if (wal.LoadSnapshot(blob) && blob.size() == sizeof ref) {
+            memcpy(&ref, blob.data(), sizeof ref);
+            rec.fromSnapshot = OpenChain(ref) && LoadAccounts(accounts, ledgers);
+            if (rec.fromSnapshot) { last = ref; persisted = accounts.Size(); }
+            else ledgers.clear();
+        }
+        rec.replayed = wal.Replay([&](const WalRecord& r) { accounts.Apply(r, msg); });
+        rec.persistent = wal.Start();
+        if (rec.persistent) accounts.SetJournal([this](const WalRecord& r) { wal.Append(r); });
+        return rec;
+    }
+
+    // Applies an operation and, if it succeeds, logs it. Safe to call from
+    // several threads.
+    bool Commit(const WalRecord& r, std::string& msg) {
+        if (!accounts.Apply(r, msg)) return false;
+        if (wal.RecordsSinceCheckpoint() >= snapshotInterval) Checkpoint();
+        return true;
+    }
+
+    // Captures the rows added since the last segment here; the new segment
+    // is written and fsynced on the log's commit thread, after which the
+    // accounts read those rows from it and drop their in-memory copies.
+    // Older segments are never rewritten. One checkpoint at a time: until
+    // the last one is written its rows are still in memory, and a second
+    // cut would write them again.
+    void Checkpoint() {
+        if (!wal.Running() || checkpointing.exchange(true)) return;
+        auto cut = std::make_shared<Cut>(checkpointing);
+        accounts.Quiesce([this, &cut] {
+            cut->accounts = CaptureAccounts(accounts, persisted);
+            cut->nextId = accounts.NextId();
+            cut->size = accounts.Size();
+            wal.Checkpoint([this, cut](uint64_t lsn, std::string& blob) {
+                SnapshotRef ref{lsn, last.crc, 0};
+                bool ok = lsn == last.lsn   // nothing logged since that segment
+                    || (WriteLedgerFile(LedgerPath(lsn), cut->accounts, cut->nextId, last.lsn, last.crc, ref.crc)
+                        && Rebase(*cut, LedgerPath(lsn), ref.crc));
+                if (ok) {
+                    last = ref;
+                    persisted = cut->size;
+                    blob.assign((const char*)&ref, sizeof ref);
+                }
+                cut->Done();
+                return ok;
+            });
+        });
+    }
+
+    // Blocks until every committed operation is on disk.
+    void Flush() { wal.Flush(); }
+
+    // A final snapshot leaves nothing in the log to replay.
+    void Close() {
+        if (!wal.Running()) return;
+        wal.Flush();   // lets a checkpoint in progress finish first
+        Checkpoint();
+        wal.Close();
+    }
+
+    bool LogFailed() { return wal.Failed(); }
+
+    // Read access to the accounts; see TransactionEngine.
+    size_t Size() const { return accounts.Size(); }
+    Customer& At(size_t i) { return accounts.At(i); }
+    const Customer& At(size_t i) const { return accounts.At(i); }
+    int IndexOf(int id) const { return accounts.IndexOf(id); }
+    std::unique_lock<std::mutex> LockAccount(size_t i) const { return accounts.LockAccount(i); }
+    size_t FindByName(const std::string& prefix, size_t offset, size_t limit, std::vector<int>& out) {
+        return accounts.FindByName(prefix, offset, limit, out);
+    }
+    Money TotalBalance() { return accounts.TotalBalance(); }
+
+    TransactionEngine& Engine() { return accounts; }
+
+private:
+    // One checkpoint's captured rows. Holds `checkpointing` until Done(), or
+    // until the log drops the builder without running it (the log failed
+    // or was closed first).
+    struct Cut {
+        explicit Cut(std::atomic<bool>& busy) : busy(&busy) {}
+        ~Cut() { Done(); }
+        Cut(const Cut&) = delete;
+        Cut& operator=(const Cut&) = delete;
+
+        void Done() {
+            if (busy) *busy = false;
+            busy = nullptr;
+        }
+
+        std::vector<LedgerCutEntry> accounts;
+        int nextId = 0;
+        size_t size = 0;   // accounts in the bank at the cut
+        std::atomic<bool>* busy;
+    };
+
+    std::string LedgerPath(uint64_t lsn) const { return base + ".ledger." + std::to_string(lsn); }
+
+    // Maps the segments `ref` leads back through into `ledgers`, oldest first.
+    bool OpenChain(SnapshotRef ref) {
+        for (uint64_t lsn = ref.lsn; lsn; ) {
+            auto file = std::make_shared<LedgerFile>();
+            if (!file->Open(LedgerPath(lsn), ref.crc) || file->PrevLsn() >= lsn) return false;
+            ledgers.insert(ledgers.begin(), file);
+            ref.crc = file->PrevCrc();
+            lsn = file->PrevLsn();
+        }
+        return true;
+    }
+
+    // Commit thread: switches the captured rows to the segment just written.
+    // False if it can't be mapped; the rows would then go into the next
+    // segment again, so the checkpoint fails instead.
+    bool Rebase(const Cut& cut, const std::string& path, uint32_t crc) {
+        auto file = std::make_shared<LedgerFile>();
+        if (!file->Open(path, crc) || file->Accounts() != cut.accounts.size()) return false;
+        accounts.Quiesce([&] {
+            for (size_t i = 0; i < cut.accounts.size(); ++i) {
+                const LedgerAccountEntry& e = file->Account(i);
+                accounts.At(cut.accounts[i].slot).account.history.Rebase(file->Rows(e), (size_t)e.count);
+            }
+            ledgers.push_back(file);
+        });
+        return true;
+    }
+
+    std::string base;
+    std::vector<std::shared_ptr<LedgerFile>> ledgers;   // mappings the histories read from; grown under Quiesce
+    TransactionEngine accounts;
+    WriteAheadLog wal;
+    SnapshotRef last{0, 0, 0};   // newest published segment; commit thread
+    size_t persisted = 0;        // accounts held by the segments; commit thread
+    std::atomic<bool> checkpointing{false};
+};
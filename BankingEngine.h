@@ -0,0 +1,236 @@
+// Banking accounts and a thread-safe transaction engine. Any number of
+// producers (GUI, load generators, batch imports) may apply operations
+// concurrently. No raylib dependency.
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "BankingIndex.h"
+#include "BankingLedger.h"
+#include "BankingMoney.h"
+#include "BankingStats.h"
+#include "BankingWAL.h"
+
+// ---------- Data Models ----------
+// Transactions live in a columnar Ledger (BankingLedger.h); their text is
+// formatted only when a row is drawn. Statement figures come from `stats`
+// (BankingStats.h) rather than from walking the history.
+struct Account {
+    int id;
+    Money balance;
+    Ledger history;
+    AccountStats stats;
+
+    // Explicit constructor for robust object creation
+    Account(int account_id = 0) : id(account_id), balance() {}
+
+    // `when` is passed in rather than read here so that replaying the
+    // write-ahead log reproduces the original timestamps.
+    // Called after `balance` has been updated; the row records it.
+    void AddTransaction(TxType type, Money amt, int counterparty, time_t when) {
+        TxRow row{type, (int64_t)when, amt, counterparty, balance};
+        row.time = history.Append(row);
+        if (stats.InSync(history.Size() - 1)) stats.Add(row);
+    }
+
+    // Day buckets brought up to date with the history (O(1) once synced).
+    const AccountStats& Stats() {
+        stats.Sync(history);
+        return stats;
+    }
+
+    bool Deposit(Money amt, std::string& msg, time_t when) {
+        if (!amt.IsPositive()) { msg = "Invalid deposit amount"; return false; }
+        if (!CheckedAdd(balance, amt, balance)) { msg = "Deposit rejected: balance limit reached"; return false; }
+        AddTransaction(TxType::Deposit, amt, 0, when);
+        msg = "Deposit successful";
+        return true;
+    }
+
+    bool Withdraw(Money amt, std::string& msg, time_t when) {
+        if (!amt.IsPositive()) { msg = "Invalid withdrawal amount"; return false; }
+        if (amt > balance) { msg = "Unable to withdraw: Insufficient funds"; return false; }
+        balance -= amt;
+        AddTransaction(TxType::Withdrawal, amt, 0, when);
+        msg = "Withdrawal successful";
+        return true;
+    }
+
+    void ReceiveFunds(Money amt, int from_account_id, time_t when) {
+        balance += amt;
+        AddTransaction(TxType::TransferIn, amt, from_account_id, when);
+    }
+
+    bool Transfer(Account& to, Money amt, std::string& msg, time_t when) {
+        Money received;
+        if (!amt.IsPositive()) { msg = "Invalid transfer amount"; return false; }
+        if (amt > balance) { msg = "Unable to transfer: Insufficient funds"; return false; }
+        if (!CheckedAdd(to.balance, amt, received)) { msg = "Transfer rejected: balance limit reached"; return false; }
+        balance -= amt;
+        AddTransaction(TxType::TransferOut, amt, to.id, when);
+        to.ReceiveFunds(amt, id, when);
+        msg = "Transfer successful";
+        return true;
+    }
+};
+
+struct Customer {
+    int id{};
+    std::string name;
+    Account account;
+};
+
+// ---------- Transaction Engine ----------
+// Accounts live in fixed-size chunks that are never moved, so a slot index
+// or Customer& stays valid while other threads add customers. Account ids
+// map to slots through a lock-free hash index; names are searchable by
+// prefix. Each account has its own mutex; a transfer locks both accounts in
+// slot order, so two opposite transfers can't deadlock and no update is
+// lost. Operations are WalRecords, the same form the write-ahead log stores.
+class TransactionEngine {
+public:
+    // Called with the touched accounts still locked, so the journal sees
+    // conflicting operations in the order they were applied.
+    using Journal = std::function<void(const WalRecord&)>;
+
+    static constexpr size_t CHUNK_BITS = 12;
+    static constexpr size_t CHUNK = size_t(1) << CHUNK_BITS;
+    static constexpr size_t MAX_CHUNKS = 4096;          // 16M accounts
+
+    // Set while no operations are running (e.g. after replay at startup).
+    void SetJournal(Journal j) { journal = std::move(j); }
+
+    size_t Size() const { return count.load(std::memory_order_acquire); }
+    int NextId() const { return nextId.load(std::memory_order_acquire); }
+
+    // Slot of account `id`, or -1. O(1) and lock-free.
+    int IndexOf(int id) const { return ids.Find(id); }
+
+    // Customers whose name starts with `prefix` (case-insensitive), in name
+    // order: appends slots [offset, offset+limit) of the matches to `out` and
+    // returns the number of matches. Not callable from inside Quiesce().
+    size_t FindByName(const std::string& prefix, size_t offset, size_t limit, std::vector<int>& out) {
+        std::lock_guard<std::mutex> lk(adders);
+        return names.Find(prefix, offset, limit, out);
+    }
+
+    // The id and name never change once added; balance and history must be
+    // read under LockAccount() when other producers may be running.
+    Customer& At(size_t i) { return SlotAt(i).customer; }
+    const Customer& At(size_t i) const { return SlotAt(i).customer; }
+    std::unique_lock<std::mutex> LockAccount(size_t i) const { return std::unique_lock<std::mutex>(SlotAt(i).lock); }
+
+    // Applies one operation. AddCustomer with account 0 takes the next free
+    // id; a replayed or imported one keeps its own (any unused positive id).
+    bool Apply(WalRecord r, std::string& msg) {
+        time_t when = (time_t)r.time;
+        Money amt = Money::FromMinor(r.amount);
+        if (r.op == WalOp::AddCustomer) {
+            std::lock_guard<std::mutex> lk(adders);
+            if (r.account == 0) r.account = NextId();
+            if (r.account < 1 || ids.Find(r.account) != -1) { msg = "Account id already in use"; return false; }
+            if (Size() == CHUNK * MAX_CHUNKS) { msg = "Account limit reached"; return false; }
+            // Journaled before the account is visible, so no operation on it
+            // can reach the log ahead of its creation.
+            if (journal) journal(r);
+            Customer& c = Add(r.account, std::string(r.name, strnlen(r.name, sizeof(r.name))));
+            msg = "Customer added: " + c.name;
+            return true;
+        }
+        int a = IndexOf(r.account);
+        if (a == -1) { msg = "Unknown account"; return false; }
+        bool ok = false;
+        if (r.op == WalOp::Transfer) {
+            int b = IndexOf(r.counterparty);
+            if (b == -1 || b == a) { msg = "Invalid transfer target"; return false; }
+            std::lock_guard<std::mutex> first(SlotAt(std::min(a, b)).lock);
+            std::lock_guard<std::mutex> second(SlotAt(std::max(a, b)).lock);
+            ok = At(a).account.Transfer(At(b).account, amt, msg, when);
+            if (ok && journal) journal(r);
+            return ok;
+        }
+        std::lock_guard<std::mutex> lk(SlotAt(a).lock);
+        Account& acc = At(a).account;
+        if (r.op == WalOp::Deposit) ok = acc.Deposit(amt, msg, when);
+        else if (r.op == WalOp::Withdraw) ok = acc.Withdraw(amt, msg, when);
+        else { msg = "Unknown operation"; return false; }
+        if (ok && journal) journal(r);
+        return ok;
+    }
+
+    // Runs fn with every account locked (in slot order) and no customer being
+    // added: a consistent cut for snapshots and audits.
+    template <typename Fn>
+    void Quiesce(Fn fn) {
+        std::lock_guard<std::mutex> lk(adders);
+        size_t n = Size();
+        for (size_t i = 0; i < n; i++) SlotAt(i).lock.lock();
+        fn();
+        for (size_t i = n; i-- > 0;) SlotAt(i).lock.unlock();
+    }
+
+    Money TotalBalance() {
+        Money total;
+        Quiesce([&] { for (size_t i = 0; i < Size(); i++) total += At(i).account.balance; });
+        return total;
+    }
+
+    // Startup only (no concurrent producers): drops every account, then
+    // Restore() re-adds them from a snapshot without journaling.
+    void Clear() {
+        std::lock_guard<std::mutex> lk(adders);
+        for (auto& c : chunks) c.reset();
+        count.store(0, std::memory_order_release);
+        nextId.store(1, std::memory_order_release);
+        ids.Clear();
+        names.Clear();
+    }
+
+    // nullptr if the id is invalid or taken.
+    Customer* Restore(int id, const std::string& name) {
+        std::lock_guard<std::mutex> lk(adders);
+        if (id < 1 || ids.Find(id) != -1 || Size() == CHUNK * MAX_CHUNKS) return nullptr;
+        return &Add(id, name);
+    }
+
+private:
+    struct Slot {
+        std::mutex lock;
+        Customer customer;
+    };
+
+    Slot& SlotAt(size_t i) const { return chunks[i >> CHUNK_BITS][i & (CHUNK - 1)]; }
+
+    // Caller holds `adders` and has checked that `id` is free. The slot is
+    // filled before `count` and the id index publish it.
+    Customer& Add(int id, std::string name) {
+        size_t n = Size();
+        std::unique_ptr<Slot[]>& chunk = chunks[n >> CHUNK_BITS];
+        if (!chunk) chunk.reset(new Slot[CHUNK]);
+        Customer& c = chunk[n & (CHUNK - 1)].customer;
+        c.id = id;
+        c.name = std::move(name);
+        c.account = Account(id);
+        count.store(n + 1, std::memory_order_release);
+        ids.Insert(id, (int)n);
+        names.Insert(c.name, (int)n);
+        if (id >= NextId() && id < INT32_MAX) nextId.store(id + 1, std::memory_order_release);
+        return c;
+    }
+
+    std::array<std::unique_ptr<Slot[]>, MAX_CHUNKS> chunks;
+    std::atomic<size_t> count{0};
+    std::atomic<int> nextId{1};
+    IdIndex ids;                // lock-free reads; written under `adders`
+    NameIndex names;            // guarded by `adders`
+    std::mutex adders;
+    Journal journal;
+};
@@ -0,0 +1,146 @@
+// Lookup structures for the customer store: an open-addressing hash from
+// account id to storage slot, readable without locks, and a case-insensitive
+// name index answering prefix queries a page at a time. No raylib dependency.
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ------------------- Id Index -------------------
+// Linear probing over 64-bit entries (id << 32 | slot + 1, 0 = empty). Ids
+// are never removed, so there are no tombstones. Find() takes no lock and
+// may run alongside one Insert(): entries are published with release stores,
+// and growing builds a complete new table before switching to it. Replaced
+// tables are kept until Clear() so a concurrent reader never sees freed
+// memory; together they cost less than the live table again.
+class IdIndex {
+public:
+    static constexpr int MIN_BITS = 10;
+
+    IdIndex() { Clear(); }
+
+    IdIndex(const IdIndex&)=delete;
+    IdIndex &operator=(const IdIndex&)=delete;
+
+    // Slot holding `id`, or -1.
+    int Find(int32_t id) const {
+        const Table *t=current.load(std::memory_order_acquire);
+        for (size_t i=t->Home(id);;i=(i+1)&t->mask) {
+            uint64_t e=t->slots[i].load(std::memory_order_acquire);
+            if (e==0) return -1;
+            if (KeyOf(e)==id) return SlotOf(e);
+        }
+    }
+
+    // Callers serialise writers. Returns false if `id` is already present.
+    bool Insert(int32_t id, int slot) {
+        if (Find(id)!=-1) return false;
+        Table *t=current.load(std::memory_order_relaxed);
+        if ((count+1)*4>(t->mask+1)*3) t=Grow(t);   // keep load under 3/4
+        Place(*t,Pack(id,slot),std::memory_order_release);
+        count++;
+        return true;
+    }
+
+    size_t Size() const { return count; }
+
+    // No concurrent readers allowed.
+    void Clear() {
+        tables.clear();
+        tables.emplace_back(new Table(MIN_BITS));
+        current.store(tables.back().get(),std::memory_order_release);
+        count=0;
+    }
+
+private:
+    struct Table {
+        explicit Table(int bits) : bits(bits), mask((size_t(1)<<bits)-1), slots(new std::atomic<uint64_t>[mask+1]) {
+            for (size_t i=0;i<=mask;i++) slots[i].store(0,std::memory_order_relaxed);
+        }
+        // Fibonacci hashing spreads sequential and clustered account numbers.
+        size_t Home(int32_t id) const { return (size_t)(((uint64_t)(uint32_t)id*0x9E3779B97F4A7C15ull)>>(64-bits)); }
+
+        int bits;
+        size_t mask;
+        std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    };
+
+    static uint64_t Pack(int32_t id, int slot) { return (uint64_t)(uint32_t)id<<32 | (uint32_t)(slot+1); }
+    static int32_t KeyOf(uint64_t e) { return (int32_t)(uint32_t)(e>>32); }
+    static int SlotOf(uint64_t e) { return (int)(uint32_t)e-1; }
+
+    static void Place(Table &t, uint64_t e, std::memory_order order) {
+        size_t i=t.Home(KeyOf(e));
+        while (t.slots[i].load(std::memory_order_relaxed)!=0) i=(i+1)&t.mask;
+        t.slots[i].store(e,order);
+    }
+
+    Table *Grow(Table *old) {
+        tables.emplace_back(new Table(old->bits+1));
+        Table *t=tables.back().get();
+        for (size_t i=0;i<=old->mask;i++) {
+            uint64_t e=old->slots[i].load(std::memory_order_relaxed);
+            if (e) Place(*t,e,std::memory_order_relaxed);
+        }
+        current.store(t,std::memory_order_release);
+        return t;
+    }
+
+    std::vector<std::unique_ptr<Table>> tables;   // back() is current
+    std::atomic<Table*> current{nullptr};
+    size_t count=0;
+};
+
+// ------------------- Name Index -------------------
+// Case-folded names sorted for prefix search. Inserts go to an unsorted tail
+// that the next query sorts and merges in, so a bulk load (snapshot, replay)
+// costs one O(n log n) sort instead of an O(n) shift per customer. Not
+// thread-safe; the engine guards it.
+class NameIndex {
+public:
+    void Insert(const std::string &name, int slot) { recent.push_back(Entry{Fold(name),slot}); }
+
+    void Clear() { sorted.clear(); recent.clear(); }
+
+    size_t Size() const { return sorted.size()+recent.size(); }
+
+    // Slots whose name starts with `prefix` (case-insensitive), in name
+    // order: appends entries [offset, offset+limit) of the matches to `out`
+    // and returns how many match in total. O(log n + limit).
+    size_t Find(const std::string &prefix, size_t offset, size_t limit, std::vector<int> &out) {
+        Merge();
+        std::string p=Fold(prefix);
+        auto lo=std::lower_bound(sorted.begin(),sorted.end(),p,[](const Entry &e, const std::string &k){ return e.key<k; });
+        auto hi=std::partition_point(lo,sorted.end(),[&](const Entry &e){ return e.key.compare(0,p.size(),p)==0; });
+        size_t total=(size_t)(hi-lo);
+        for (auto it=lo+std::min(offset,total);it!=hi && limit>0;++it,--limit) out.push_back(it->slot);
+        return total;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        int slot;
+        bool operator<(const Entry &o) const { return key!=o.key ? key<o.key : slot<o.slot; }
+    };
+
+    static std::string Fold(std::string s) {
+        for (char &ch: s) ch=(char)std::tolower((unsigned char)ch);
+        return s;
+    }
+
+    void Merge() {
+        if (recent.empty()) return;
+        std::sort(recent.begin(),recent.end());
+        size_t mid=sorted.size();
+        sorted.insert(sorted.end(),std::make_move_iterator(recent.begin()),std::make_move_iterator(recent.end()));
+        std::inplace_merge(sorted.begin(),sorted.begin()+mid,sorted.end());
+        recent.clear();
+    }
+
+    std::vector<Entry> sorted, recent;
+};
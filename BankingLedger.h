@@ -0,0 +1,170 @@
+// Columnar per-account transaction storage: one contiguous array per field
+// instead of a vector of records holding strings, so appends never allocate
+// per entry and scans touch only the columns they need. Older rows can stay
+// in read-only blocks of fixed records (memory-mapped ledger segments, see
+// BankingLedgerFile.h) that are never copied. Human-readable text is produced
+// on demand, only for rows that are actually shown.
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <vector>
+#include "BankingMoney.h"
+
+// ------------------- Transaction Rows -------------------
+enum class TxType : uint8_t { Deposit, Withdrawal, TransferIn, TransferOut };
+
+inline const char *TxTypeName(TxType t) {
+    switch (t) {
+        case TxType::Deposit: return "Deposit";
+        case TxType::Withdrawal: return "Withdrawal";
+        case TxType::TransferIn: return "Transfer In";
+        default: return "Transfer Out";
+    }
+}
+
+struct TxRow {
+    TxType type=TxType::Deposit;
+    int64_t time=0;             // epoch seconds
+    Money amount;
+    int32_t counterparty=0;     // other account of a transfer, 0 otherwise
+    Money balance;              // account balance right after this row
+};
+
+// Fixed 32-byte form of a row in ledger files (little-endian hosts).
+struct LedgerRecord {
+    int64_t time;
+    int64_t amount;             // minor units
+    int64_t balance;            // minor units, after this row
+    int32_t counterparty;
+    TxType type;
+    uint8_t pad[3];
+};
+static_assert(sizeof(LedgerRecord)==32, "LedgerRecord must stay 32 bytes");
+
+inline TxRow FromRecord(const LedgerRecord &r) {
+    return TxRow{r.type,r.time,Money::FromMinor(r.amount),r.counterparty,Money::FromMinor(r.balance)};
+}
+
+// ------------------- Ledger -------------------
+// Rows [0, BaseSize()) come from the attached blocks, oldest first, later
+// ones from the in-memory columns. Blocks must outlive the ledger or the
+// next Clear().
+class Ledger {
+public:
+    // Keeps rows in time order, which CountUpTo() relies on: a row stamped
+    // before the last one (the wall clock stepped back) is stored at the
+    // last one's time. Returns the time stored.
+    int64_t Append(const TxRow &r) {
+        int64_t t=Empty() ? r.time : std::max(r.time,TimeAt(Size()-1));
+        types.push_back(r.type);
+        times.push_back(t);
+        amounts.push_back(r.amount.minor);
+        counterparties.push_back(r.counterparty);
+        balances.push_back(r.balance.minor);
+        return t;
+    }
+
+    void Reserve(size_t n) {
+        types.reserve(n); times.reserve(n); amounts.reserve(n); counterparties.reserve(n); balances.reserve(n);
+    }
+
+    // Adds `n` read-only records, read in place, after the attached ones.
+    // Only while there are no in-memory rows (e.g. while loading).
+    void Attach(const LedgerRecord *rows, size_t n) {
+        if (n==0) return;
+        baseCount+=n;
+        blocks.push_back(Block{rows,baseCount});
+    }
+
+    // Moves the oldest `n` in-memory rows to a new block holding the same
+    // rows, e.g. a freshly written ledger segment, and frees their copies.
+    void Rebase(const LedgerRecord *rows, size_t n) {
+        types.erase(types.begin(),types.begin()+n); types.shrink_to_fit();
+        times.erase(times.begin(),times.begin()+n); times.shrink_to_fit();
+        amounts.erase(amounts.begin(),amounts.begin()+n); amounts.shrink_to_fit();
+        counterparties.erase(counterparties.begin(),counterparties.begin()+n); counterparties.shrink_to_fit();
+        balances.erase(balances.begin(),balances.begin()+n); balances.shrink_to_fit();
+        Attach(rows,n);
+    }
+
+    void Clear() {
+        blocks.clear(); baseCount=0;
+        types.clear(); times.clear(); amounts.clear(); counterparties.clear(); balances.clear();
+    }
+
+    size_t Size() const { return baseCount+types.size(); }
+    bool Empty() const { return Size()==0; }
+
+    TxRow At(size_t i) const {
+        if (i<baseCount) return FromRecord(Record(i));
+        i-=baseCount;
+        return TxRow{types[i],times[i],Money::FromMinor(amounts[i]),counterparties[i],Money::FromMinor(balances[i])};
+    }
+
+    int64_t TimeAt(size_t i) const { return i<baseCount ? Record(i).time : times[i-baseCount]; }
+    Money BalanceAt(size_t i) const { return Money::FromMinor(i<baseCount ? Record(i).balance : balances[i-baseCount]); }
+
+    // Number of rows stamped at or before `t`; Append() keeps them in time order.
+    size_t CountUpTo(int64_t t) const {
+        size_t lo=0, hi=Size();
+        while (lo<hi) {
+            size_t mid=lo+(hi-lo)/2;
+            if (TimeAt(mid)<=t) lo=mid+1; else hi=mid;
+        }
+        return lo;
+    }
+
+    // Rows in attached blocks, and the later ones in record form.
+    size_t BaseSize() const { return baseCount; }
+    void CopyTail(std::vector<LedgerRecord> &out) const {
+        for (size_t i=0;i<types.size();i++)
+            out.push_back(LedgerRecord{times[i],amounts[i],balances[i],counterparties[i],types[i],{}});
+    }
+
+private:
+    struct Block {
+        const LedgerRecord *rows;
+        size_t end;             // rows in this block and every earlier one
+    };
+
+    // Attached row i; most reads hit the newest block, so try it first.
+    const LedgerRecord &Record(size_t i) const {
+        auto b=blocks.end()-1;
+        if (b!=blocks.begin() && i<b[-1].end)
+            b=std::upper_bound(blocks.begin(),b,i,[](size_t v, const Block &x) { return v<x.end; });
+        return b->rows[i-(b==blocks.begin() ? 0 : b[-1].end)];
+    }
+
+    std::vector<Block> blocks;
+    size_t baseCount=0;
+    std::vector<TxType> types;
+    std::vector<int64_t> times;
+    std::vector<int64_t> amounts;
+    std::vector<int32_t> counterparties;
+    std::vector<int64_t> balances;
+};
+
+// ------------------- Formatting -------------------
+// "2024-05-01 14:03" in local time.
+inline void FormatTimestamp(int64_t t, char *buf, size_t n) {
+    time_t when=(time_t)t;
+    struct tm local{};
+#if defined(_WIN32)
+    localtime_s(&local,&when);
+#else
+    localtime_r(&when,&local);
+#endif
+    strftime(buf,n,"%Y-%m-%d %H:%M",&local);
+}
+
+// One history line, e.g. "[2024-05-01 14:03] Transfer Out 12.50 To Acc 7".
+inline int FormatTxRow(const TxRow &r, char *buf, size_t n) {
+    char when[32], amount[32];
+    FormatTimestamp(r.time,when,sizeof when);
+    FormatMoney(r.amount,amount,sizeof amount);
+    const char *dir=r.type==TxType::TransferIn ? " From Acc " : r.type==TxType::TransferOut ? " To Acc " : nullptr;
+    if (dir) return std::snprintf(buf,n,"[%s] %s %s%s%d",when,TxTypeName(r.type),amount,dir,r.counterparty);
+    return std::snprintf(buf,n,"[%s] %s %s",when,TxTypeName(r.type),amount);
+}
@@ -0,0 +1,207 @@
+// Ledger segments: the transactions added since the previous segment as
+// fixed 32-byte records, grouped by account behind a directory of offsets.
+// Each names the segment before it, so a chain of them holds the whole
+// history and a checkpoint writes only what is new. Opening one maps it
+// read-only and reads only the header and directory, so startup cost depends
+// on the number of accounts and segments, not on the number of transactions,
+// and history pages are faulted in only when something reads them. No raylib dependency.
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "BankingLedger.h"
+#include "BankingWAL.h"
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ------------------- Mapped File -------------------
+class MappedFile {
+public:
+    MappedFile()=default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&)=delete;
+    MappedFile &operator=(const MappedFile&)=delete;
+
+    // Maps the whole file read-only; false if it is missing or empty.
+    bool Open(const std::string &path) {
+        Close();
+#if defined(_WIN32)
+        HANDLE f=CreateFileA(path.c_str(),GENERIC_READ,FILE_SHARE_READ|FILE_SHARE_DELETE,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+        if (f==INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER len;
+        HANDLE m=nullptr;
+        if (GetFileSizeEx(f,&len) && len.QuadPart>0) m=CreateFileMappingA(f,nullptr,PAGE_READONLY,0,0,nullptr);
+        CloseHandle(f);
+        if (!m) return false;
+        data=(const uint8_t*)MapViewOfFile(m,FILE_MAP_READ,0,0,0);
+        CloseHandle(m);
+        if (!data) return false;
+        size=(size_t)len.QuadPart;
+#else
+        int fd=open(path.c_str(),O_RDONLY);
+        if (fd<0) return false;
+        struct stat st;
+        void *p=MAP_FAILED;
+        if (fstat(fd,&st)==0 && st.st_size>0) p=mmap(nullptr,(size_t)st.st_size,PROT_READ,MAP_SHARED,fd,0);
+        close(fd);
+        if (p==MAP_FAILED) return false;
+        data=(const uint8_t*)p;
+        size=(size_t)st.st_size;
+#endif
+        return true;
+    }
+
+    void Close() {
+        if (!data) return;
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+#else
+        munmap((void*)data,size);
+#endif
+        data=nullptr; size=0;
+    }
+
+    const uint8_t *Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const uint8_t *data=nullptr;
+    size_t size=0;
+};
+
+// ------------------- Format -------------------
+// "BKLG" header | AccountEntry[accounts] | LedgerRecord[rows]. The directory
+// lists the accounts that are new or gained rows since the previous segment
+// (prevLsn, 0 for the first); an account's new rows are contiguous, starting
+// at its `first`. `crc` covers the header (with crc=0) and the directory; the
+// rows are fsynced before the snapshot that names the segment is published,
+// and are not checksummed so that opening never has to read them.
+struct LedgerFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t accounts;
+    uint64_t rows;
+    int32_t nextId;
+    uint32_t crc;
+    uint64_t prevLsn;
+    uint32_t prevCrc;
+    uint32_t pad;
+};
+static_assert(sizeof(LedgerFileHeader)==48, "LedgerFileHeader must stay 48 bytes");
+
+struct LedgerAccountEntry {
+    int32_t id;
+    uint32_t pad;
+    int64_t balance;            // minor units
+    uint64_t first;             // index of the account's first row in this segment
+    uint64_t count;
+    char name[24];              // NUL-terminated
+};
+static_assert(sizeof(LedgerAccountEntry)==56, "LedgerAccountEntry must stay 56 bytes");
+
+constexpr uint32_t LEDGER_FILE_VERSION = 3;   // 2: running balance per record, 3: chained segments
+
+// One account as captured for writing: its slot in the engine and the rows
+// that no earlier segment holds.
+struct LedgerCutEntry {
+    size_t slot;
+    int id;
+    std::string name;
+    Money balance;
+    std::vector<LedgerRecord> tail;
+};
+
+// ------------------- Writing -------------------
+// Writes `path` through a temporary file and fsyncs it before the rename.
+inline bool WriteLedgerFile(const std::string &path, const std::vector<LedgerCutEntry> &accounts, int nextId,
+                            uint64_t prevLsn, uint32_t prevCrc, uint32_t &crcOut) {
+    LedgerFileHeader h{{'B','K','L','G'},LEDGER_FILE_VERSION,(uint32_t)sizeof(LedgerRecord),(uint32_t)accounts.size(),0,nextId,0,prevLsn,prevCrc,0};
+    std::vector<LedgerAccountEntry> dir(accounts.size());
+    for (size_t i=0;i<accounts.size();i++) {
+        const LedgerCutEntry &a=accounts[i];
+        LedgerAccountEntry &e=dir[i];
+        e.id=a.id;
+        e.pad=0;
+        e.balance=a.balance.minor;
+        e.first=h.rows;
+        e.count=a.tail.size();
+        std::memset(e.name,0,sizeof e.name);
+        std::memcpy(e.name,a.name.data(),std::min(a.name.size(),sizeof(e.name)-1));
+        h.rows+=e.count;
+    }
+    h.crc=Crc32(dir.data(),dir.size()*sizeof(LedgerAccountEntry),Crc32(&h,sizeof h));
+
+    std::string tmp=path+".tmp";
+    FILE *f=std::fopen(tmp.c_str(),"wb");
+    if (!f) return false;
+    bool ok=std::fwrite(&h,sizeof h,1,f)==1 && std::fwrite(dir.data(),sizeof(LedgerAccountEntry),dir.size(),f)==dir.size();
+    for (size_t i=0;ok && i<accounts.size();i++) {
+        const LedgerCutEntry &a=accounts[i];
+        ok=std::fwrite(a.tail.data(),sizeof(LedgerRecord),a.tail.size(),f)==a.tail.size();
+    }
+    ok=ok && SyncFile(f);
+    ok=std::fclose(f)==0 && ok;
+#if defined(_WIN32)
+    if (ok) std::remove(path.c_str());   // rename() won't replace on Windows
+#endif
+    if (!ok || std::rename(tmp.c_str(),path.c_str())!=0) { std::remove(tmp.c_str()); return false; }
+    crcOut=h.crc;
+    return true;
+}
+
+// ------------------- Reading -------------------
+// A mapped ledger segment. Records and directory entries point into the
+// mapping and stay valid until Close() or the next Open().
+class LedgerFile {
+public:
+    // Maps `path` and checks the header and directory, whose crc must equal
+    // `crc` (recorded by the snapshot or segment that names this one).
+    bool Open(const std::string &path, uint32_t crc) {
+        if (!map.Open(path)) return false;
+        const LedgerFileHeader *h=Header();
+        bool ok=map.Size()>=sizeof *h && std::memcmp(h->magic,"BKLG",4)==0 && h->version==LEDGER_FILE_VERSION
+            && h->recordSize==sizeof(LedgerRecord) && h->crc==crc
+            && map.Size()==sizeof *h+(uint64_t)h->accounts*sizeof(LedgerAccountEntry)+h->rows*sizeof(LedgerRecord);
+        if (ok) {
+            LedgerFileHeader zeroed=*h;
+            zeroed.crc=0;
+            ok=Crc32(Directory(),h->accounts*sizeof(LedgerAccountEntry),Crc32(&zeroed,sizeof zeroed))==crc;
+        }
+        for (uint32_t i=0;ok && i<h->accounts;i++) {
+            const LedgerAccountEntry &e=Directory()[i];
+            ok=e.first<=h->rows && e.count<=h->rows-e.first && std::memchr(e.name,0,sizeof e.name);
+        }
+        if (!ok) map.Close();
+        return ok;
+    }
+
+    void Close() { map.Close(); }
+
+    size_t Accounts() const { return Header()->accounts; }
+    int NextId() const { return Header()->nextId; }
+    uint64_t PrevLsn() const { return Header()->prevLsn; }
+    uint32_t PrevCrc() const { return Header()->prevCrc; }
+    const LedgerAccountEntry &Account(size_t i) const { return Directory()[i]; }
+    const LedgerRecord *Rows(const LedgerAccountEntry &e) const {
+        return (const LedgerRecord*)(map.Data()+sizeof(LedgerFileHeader)+Accounts()*sizeof(LedgerAccountEntry))+e.first;
+    }
+
+private:
+    const LedgerFileHeader *Header() const { return (const LedgerFileHeader*)map.Data(); }
+    const LedgerAccountEntry *Directory() const { return (const LedgerAccountEntry*)(map.Data()+sizeof(LedgerFileHeader)); }
+
+    MappedFile map;
+};
@@ -0,0 +1,85 @@
+// Fixed-point money: signed 64-bit count of minor units (cents). Sums are
+// exact, comparisons never suffer float rounding, and overflow is checked
+// where user input can reach it. No raylib dependency.
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// ------------------- Money -------------------
+struct Money {
+    static constexpr int64_t SCALE = 100;      // minor units per major unit
+    static constexpr int DECIMALS = 2;
+
+    int64_t minor=0;
+
+    static constexpr Money FromMinor(int64_t v) { return Money{v}; }
+    static constexpr Money FromMajor(int64_t v) { return Money{v*SCALE}; }
+
+    constexpr bool IsZero() const { return minor==0; }
+    constexpr bool IsPositive() const { return minor>0; }
+
+    constexpr Money operator+(Money o) const { return Money{minor+o.minor}; }
+    constexpr Money operator-(Money o) const { return Money{minor-o.minor}; }
+    constexpr Money operator-() const { return Money{-minor}; }
+    Money &operator+=(Money o) { minor+=o.minor; return *this; }
+    Money &operator-=(Money o) { minor-=o.minor; return *this; }
+
+    constexpr bool operator==(Money o) const { return minor==o.minor; }
+    constexpr bool operator!=(Money o) const { return minor!=o.minor; }
+    constexpr bool operator<(Money o) const { return minor<o.minor; }
+    constexpr bool operator<=(Money o) const { return minor<=o.minor; }
+    constexpr bool operator>(Money o) const { return minor>o.minor; }
+    constexpr bool operator>=(Money o) const { return minor>=o.minor; }
+};
+
+// out = a + b; returns false (leaving out untouched) on int64 overflow.
+inline bool CheckedAdd(Money a, Money b, Money &out) {
+    int64_t r;
+    if (__builtin_add_overflow(a.minor,b.minor,&r)) return false;
+    out.minor=r;
+    return true;
+}
+
+// Parses a non-negative decimal amount such as "12", "12.5" or "0.07".
+// Rejects empty input, signs, stray characters, a second '.', more than
+// DECIMALS fraction digits and values that don't fit in int64 minor units.
+inline bool ParseMoney(const std::string &s, Money &out) {
+    int64_t major=0, frac=0;
+    int fracDigits=0;
+    bool dot=false, digits=false;
+    for (char ch: s) {
+        if (ch=='.') {
+            if (dot) return false;
+            dot=true;
+        } else if (ch>='0' && ch<='9') {
+            digits=true;
+            if (dot) {
+                if (++fracDigits>Money::DECIMALS) return false;
+                frac=frac*10+(ch-'0');
+            } else if (__builtin_mul_overflow(major,int64_t(10),&major) || __builtin_add_overflow(major,int64_t(ch-'0'),&major)) {
+                return false;
+            }
+        } else return false;
+    }
+    if (!digits) return false;
+    for (int k=fracDigits;k<Money::DECIMALS;k++) frac*=10;
+    int64_t minor;
+    if (__builtin_mul_overflow(major,Money::SCALE,&minor) || __builtin_add_overflow(minor,frac,&minor)) return false;
+    out.minor=minor;
+    return true;
+}
+
+// "1234.50", "-0.07"; always DECIMALS fraction digits, no grouping. The
+// buffer form writes at most n bytes and never allocates.
+inline int FormatMoney(Money m, char *buf, size_t n) {
+    uint64_t v=m.minor<0 ? 0-uint64_t(m.minor) : uint64_t(m.minor);
+    return std::snprintf(buf,n,"%s%llu.%0*llu",m.minor<0 ? "-" : "",
+        (unsigned long long)(v/Money::SCALE),Money::DECIMALS,(unsigned long long)(v%Money::SCALE));
+}
+
+inline std::string FormatMoney(Money m) {
+    char buf[32];
+    FormatMoney(m,buf,sizeof buf);
+    return buf;
+}
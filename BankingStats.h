@@ -0,0 +1,126 @@
+// Per-account aggregates for statements: transactions bucketed by local
+// calendar day, each bucket carrying running (prefix) totals, so a day's
+// figures and the totals over any range of days cost O(log days). With the
+// running balance stored on every ledger row, the balance at any moment is
+// a binary search over the rows. No raylib dependency.
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include "BankingLedger.h"
+
+// ------------------- Flow Totals -------------------
+struct FlowTotals {
+    Money deposits, withdrawals, transfersIn, transfersOut;
+    size_t count=0;
+
+    void Add(const TxRow &r) {
+        switch (r.type) {
+            case TxType::Deposit: deposits+=r.amount; break;
+            case TxType::Withdrawal: withdrawals+=r.amount; break;
+            case TxType::TransferIn: transfersIn+=r.amount; break;
+            case TxType::TransferOut: transfersOut+=r.amount; break;
+        }
+        count++;
+    }
+
+    FlowTotals operator-(const FlowTotals &o) const {
+        FlowTotals d;
+        d.deposits=deposits-o.deposits; d.withdrawals=withdrawals-o.withdrawals;
+        d.transfersIn=transfersIn-o.transfersIn; d.transfersOut=transfersOut-o.transfersOut;
+        d.count=count-o.count;
+        return d;
+    }
+
+    Money Net() const { return deposits+transfersIn-withdrawals-transfersOut; }
+};
+
+// ------------------- Calendar -------------------
+inline struct tm LocalTime(int64_t t) {
+    time_t when=(time_t)t;
+    struct tm local{};
+#if defined(_WIN32)
+    localtime_s(&local,&when);
+#else
+    localtime_r(&when,&local);
+#endif
+    return local;
+}
+
+// Local midnight on the first day of t's month, moved by `months`.
+inline int64_t LocalMonthStart(int64_t t, int months=0) {
+    struct tm local=LocalTime(t);
+    local.tm_mon+=months;
+    local.tm_mday=1;
+    local.tm_hour=local.tm_min=local.tm_sec=0;
+    local.tm_isdst=-1;
+    return (int64_t)mktime(&local);
+}
+
+// Local midnight at or before t.
+inline int64_t LocalDayStart(int64_t t) {
+    struct tm local=LocalTime(t);
+    local.tm_hour=local.tm_min=local.tm_sec=0;
+    local.tm_isdst=-1;
+    return (int64_t)mktime(&local);
+}
+
+// ------------------- Account Stats -------------------
+struct DayBucket {
+    int64_t start;              // local midnight
+    size_t firstRow;            // ledger index of the day's first row
+    Money closing;              // balance after the day's last row
+    FlowTotals through;         // every row up to and including this day
+};
+
+// Built lazily: Sync() folds in rows the stats haven't seen (such as those
+// mapped from a ledger file at startup, so opening a bank doesn't scan its
+// history), and Account::AddTransaction keeps synced stats current in O(1).
+// Rows are bucketed in append order; a row stamped before the current day
+// (the clock went back) counts towards the current day.
+class AccountStats {
+public:
+    void Sync(const Ledger &h) { while (seen<h.Size()) Add(h.At(seen)); }
+    bool InSync(size_t rows) const { return seen==rows; }
+
+    // Folds in the next ledger row.
+    void Add(const TxRow &r) {
+        if (days.empty() || r.time>=dayEnd) {
+            DayBucket d{LocalDayStart(r.time),seen,r.balance,days.empty() ? FlowTotals() : days.back().through};
+            days.push_back(d);
+            dayEnd=LocalDayStart(d.start+30*3600);   // next midnight, whatever the DST change
+        }
+        DayBucket &d=days.back();
+        d.through.Add(r);
+        d.closing=r.balance;
+        seen++;
+    }
+
+    const std::vector<DayBucket> &Days() const { return days; }
+    FlowTotals DayTotals(size_t i) const { return Through(i+1)-Through(i); }
+
+    // Index of the first day starting at or after t.
+    size_t FirstDayFrom(int64_t t) const {
+        return (size_t)(std::lower_bound(days.begin(),days.end(),t,[](const DayBucket &d, int64_t v){ return d.start<v; })-days.begin());
+    }
+
+    // Totals of the days starting in [from, to). O(log days).
+    FlowTotals Range(int64_t from, int64_t to) const { return Through(FirstDayFrom(to))-Through(FirstDayFrom(from)); }
+
+private:
+    // Totals of days [0, k).
+    FlowTotals Through(size_t k) const { return k==0 ? FlowTotals() : days[k-1].through; }
+
+    std::vector<DayBucket> days;
+    size_t seen=0;
+    int64_t dayEnd=INT64_MIN;
+};
+
+// Balance right after the last row stamped at or before t (zero before the
+// first). O(log n).
+inline Money BalanceAt(const Ledger &h, int64_t t) {
+    size_t n=h.CountUpTo(t);
+    return n ? h.BalanceAt(n-1) : Money();
+}
@@ -1,94 +1,56 @@
 #include <raylib.h>
+#include <raymath.h>
+#include <algorithm>
+#include <array>
 #include <string>
 #include <vector>
 #include <ctime>
 #include <cctype>
-
-// ---------- Data Models ----------
-struct Transaction {
-    std::string type;
-    float amount;
-    std::string timestamp;
-    std::string details;
-};
-
-struct Account {
-    int id;
-    float balance;
-    std::vector<Transaction> history;
-
-    // Explicit constructor for robust object creation
-    Account(int account_id = 0) : id(account_id), balance(0.0f) {}
-
-    void AddTransaction(const std::string& type, float amt, const std::string& det) {
-        time_t now = time(nullptr);
-        char buf[64];
-        strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", localtime(&now));
-        history.push_back(Transaction{type, amt, buf, det});
-    }
-
-    void Deposit(float amt) {
-        balance += amt;
-        AddTransaction("Deposit", amt, "");
-    }
-
-    bool Withdraw(float amt, std::string& msg) {
-        if (amt <= 0) { msg = "Invalid withdrawal amount"; return false; }
-        if (amt > balance) { msg = "Unable to withdraw: Insufficient funds"; return false; }
-        balance -= amt;
-        AddTransaction("Withdrawal", amt, "");
-        msg = "Withdrawal successful";
-        return true;
-    }
-
-    void ReceiveFunds(float amt, int from_account_id) {
-        balance += amt;
-        AddTransaction("Transfer In", amt, "From Acc " + std::to_string(from_account_id));
-    }
-
-    bool Transfer(Account& to, float amt, std::string& msg) {
-        if (amt <= 0) { msg = "Invalid transfer amount"; return false; }
-        if (amt > balance) { msg = "Unable to transfer: Insufficient funds"; return false; }
-        balance -= amt;
-        AddTransaction("Transfer Out", amt, "To Acc " + std::to_string(to.id));
-        to.ReceiveFunds(amt, id);
-        msg = "Transfer successful";
-        return true;
-    }
-};
-
-struct Customer {
-    int id{};
-    std::string name;
-    Account account;
-};
+#include <cstring>
+#include "BankingCore.h"
 
 // ---------- Globals ----------
-std::vector<Customer> customers;
-int nextID = 1;
+// Accounts, the operation rules and persistence live in the raylib-free core
+// (BankingCore.h). The GUI holds slot indices, which stay valid as
+// customers are added; records carry account ids (bank.IndexOf maps back).
+Bank bank("bank");
 int activeCustomer = -1;
 int transferSourceIndex = -1;
 std::string inputName;
 std::string inputAmount;
+std::string inputSearch;        // customer selector search
+std::string transferSearch;     // transfer overlay search
 bool inputNameActive = false;
 bool inputAmountActive = false;
+bool inputSearchActive = false;
 std::string message;
 float historyScrollY = 0.0f;
 bool transferMode = false;
+bool statementMode = false;     // the panel shows a monthly statement instead of the history
 
 // ---------- Helpers ----------
-float ToFloat(const std::string& s) {
-    try { return s.empty() ? 0.0f : std::stof(s); }
-    catch (...) { return 0.0f; }
+// Zero (which every operation rejects) when the field isn't a valid amount.
+Money ToMoney(const std::string& s) {
+    Money m;
+    return ParseMoney(s, m) ? m : Money();
 }
 
-void AddCustomer(const std::string& name) {
-    Customer c;
-    c.id = nextID++;
-    c.name = name;
-    c.account = Account(c.id);
-    customers.push_back(c);
-    if (activeCustomer == -1) activeCustomer = 0;
+// ---------- Persistence ----------
+// Applies a live operation and logs it; the frame never waits on disk.
+bool Commit(const WalRecord& r, std::string& msg) {
+    if (!bank.Commit(r, msg)) return false;
+    if (activeCustomer == -1 && bank.Size() > 0) activeCustomer = 0;
+    return true;
+}
+
+// Rebuilds the accounts from the last snapshot plus the log.
+std::string RecoverLedger() {
+    Bank::Recovery rec = bank.Open();
+    activeCustomer = bank.Size() > 0 ? 0 : -1;
+    if (!rec.persistent) return "Persistence disabled: cannot write bank.wal";
+    if (!rec.fromSnapshot && rec.replayed == 0) return "";
+    return TextFormat("Restored %d customers (%s%zu logged operations)", (int)bank.Size(),
+                      rec.fromSnapshot ? "snapshot + " : "", rec.replayed);
 }
 
 // ⭐ FIX: Replaced the old Button function with two specialized ones.
@@ -120,11 +82,235 @@ bool IsButtonClicked(Rectangle bounds, bool enabled = true) {
 }
 
 
+// ---------- History View ----------
+// Virtualized history list: only rows intersecting the panel are formatted
+// and drawn, so frame cost depends on the panel height, not on history size.
+// Formatted lines are kept in a small direct-mapped cache keyed by row index.
+// Rows up to the last snapshot are read straight from the memory-mapped
+// ledger file, so only the pages behind visible rows are ever loaded.
+struct HistoryView {
+    static constexpr float ROW_HEIGHT = 28.0f;
+    static constexpr size_t CACHE_ROWS = 64;    // well above the ~10 rows the panel shows
+
+    int account = -1;           // cache owner; a different account flushes it
+    size_t ledgerSize = 0;      // an append flushes it too
+    std::array<size_t, CACHE_ROWS> row{};
+    std::array<std::array<char, 96>, CACHE_ROWS> text{};
+    std::array<bool, CACHE_ROWS> valid{};
+
+    void Invalidate() { valid.fill(false); }
+
+    const char* Line(const Ledger& h, size_t i) {
+        size_t slot = i % CACHE_ROWS;
+        if (!valid[slot] || row[slot] != i) {
+            FormatTxRow(h.At(i), text[slot].data(), text[slot].size());
+            row[slot] = i;
+            valid[slot] = true;
+        }
+        return text[slot].data();
+    }
+
+    void Draw(const Account& acc, Rectangle panel, float scrollY) {
+        const Ledger& h = acc.history;
+        if (acc.id != account || h.Size() != ledgerSize) {
+            Invalidate();
+            account = acc.id;
+            ledgerSize = h.Size();
+        }
+        if (h.Empty()) return;
+        // Rows start 5 px below the panel top; include the partly visible ones.
+        size_t first = (size_t)std::max(0.0f, (scrollY - 5.0f) / ROW_HEIGHT);
+        size_t last = std::min(h.Size(), (size_t)((scrollY + panel.height) / ROW_HEIGHT) + 1);
+        for (size_t i = first; i < last; ++i) {
+            float y = panel.y + 5 + i * ROW_HEIGHT - scrollY;
+            DrawText(Line(h, i), (int)panel.x + 10, (int)y, 18, DARKGRAY);
+        }
+    }
+};
+
+HistoryView historyView;
+
+// ---------- Statement View ----------
+// Monthly statement for the active account, built from its day buckets
+// (BankingStats.h): opening and closing balance, totals per transaction type
+// and one line per active day. Rebuilt only when the account, the month or
+// the history changes; the cost is O(log n) plus the month's active days.
+struct StatementView {
+    int offset = 0;             // months before the latest active one
+    std::string title;
+    std::vector<std::string> lines;
+
+    void Shift(int months) { offset = std::min(0, offset + months); stale = true; }
+
+    // Caller holds the account's lock.
+    void Update(Account& acc) {
+        if (acc.id != account) { account = acc.id; offset = 0; stale = true; }
+        if (!stale && acc.history.Size() == ledgerSize) return;
+        stale = false;
+        ledgerSize = acc.history.Size();
+        const AccountStats& stats = acc.Stats();
+        int64_t latest = acc.history.Empty() ? (int64_t)time(nullptr) : acc.history.TimeAt(acc.history.Size() - 1);
+        int64_t month = LocalMonthStart(latest, offset), next = LocalMonthStart(latest, offset + 1);
+
+        char buf[128], a[32], b[32], c[32], d[32];
+        struct tm local = LocalTime(month);
+        strftime(buf, sizeof(buf), "Statement: %B %Y", &local);
+        title = buf;
+
+        lines.clear();
+        FlowTotals t = stats.Range(month, next);
+        FormatMoney(BalanceAt(acc.history, month - 1), a, sizeof(a));
+        FormatMoney(BalanceAt(acc.history, next - 1), b, sizeof(b));
+        snprintf(buf, sizeof(buf), "Opening %s   Closing %s   Net %s%s   (%zu transactions)", a, b,
+                 t.Net().IsPositive() ? "+" : "", FormatMoney(t.Net()).c_str(), t.count);
+        lines.push_back(buf);
+        lines.push_back(TotalsLine("Month", t));
+        for (size_t i = stats.FirstDayFrom(month), end = stats.FirstDayFrom(next); i < end; ++i) {
+            const DayBucket& day = stats.Days()[i];
+            FormatTimestamp(day.start, c, sizeof(c));
+            c[10] = '\0';       // date only
+            std::string line = TotalsLine(c, stats.DayTotals(i));
+            FormatMoney(day.closing, d, sizeof(d));
+            lines.push_back(line + "   Bal " + d);
+        }
+        if (t.count == 0) lines.push_back("No transactions this month");
+    }
+
+    void Draw(Rectangle panel, float scrollY) const {
+        size_t first = (size_t)std::max(0.0f, (scrollY - 5.0f) / HistoryView::ROW_HEIGHT);
+        size_t last = std::min(lines.size(), (size_t)((scrollY + panel.height) / HistoryView::ROW_HEIGHT) + 1);
+        for (size_t i = first; i < last; ++i) {
+            float y = panel.y + 5 + i * HistoryView::ROW_HEIGHT - scrollY;
+            DrawText(lines[i].c_str(), (int)panel.x + 10, (int)y, 18, i < 2 ? DARKBLUE : DARKGRAY);
+        }
+    }
+
+private:
+    static std::string TotalsLine(const char* label, const FlowTotals& t) {
+        char buf[160];
+        snprintf(buf, sizeof(buf), "%-10s  Dep +%s  Wd -%s  In +%s  Out -%s", label, FormatMoney(t.deposits).c_str(),
+                 FormatMoney(t.withdrawals).c_str(), FormatMoney(t.transfersIn).c_str(), FormatMoney(t.transfersOut).c_str());
+        return buf;
+    }
+
+    int account = -1;
+    size_t ledgerSize = 0;
+    bool stale = true;
+};
+
+StatementView statementView;
+
+// ---------- Customer List ----------
+// Searchable, paginated grid of customer buttons. A page's labels and
+// rectangles are built once and then reused for hit-testing and drawing
+// until the query, the page or the number of customers changes, so a frame
+// touches one page no matter how many customers exist.
+struct CustomerList {
+    static constexpr float GAP = 10.0f;
+
+    Rectangle area;             // the cells are laid out inside this
+    int cols, rows;
+
+    size_t total = 0;           // matches for the query, across all pages
+    std::vector<int> slots;     // this page's customers
+    std::vector<std::string> labels;
+    std::vector<Rectangle> rects;
+
+    CustomerList(Rectangle area, int cols, int rows) : area(area), cols(cols), rows(rows) {}
+
+    size_t PageSize() const { return (size_t)(cols * rows); }
+    size_t PageCount() const { return std::max<size_t>(1, (total + PageSize() - 1) / PageSize()); }
+    size_t Page() const { return page; }
+
+    // A name prefix (case-insensitive), or digits for an account number.
+    void SetQuery(const std::string& q) {
+        if (q == query) return;
+        query = q;
+        page = 0;
+        stale = true;
+    }
+    void NextPage() { if (page + 1 < PageCount()) { page++; stale = true; } }
+    void PrevPage() { if (page > 0) { page--; stale = true; } }
+
+    void Refresh() {
+        if (!stale && builtSize == bank.Size()) return;
+        stale = false;
+        builtSize = bank.Size();
+        slots.clear(); labels.clear(); rects.clear();
+        bool number = !query.empty() && std::all_of(query.begin(), query.end(), [](char ch) { return ch >= '0' && ch <= '9'; });
+        if (number) {
+            int slot = query.size() <= 9 ? bank.IndexOf(std::atoi(query.c_str())) : -1;
+            total = slot >= 0 ? 1 : 0;
+            if (slot >= 0 && page == 0) slots.push_back(slot);
+        } else {
+            total = bank.FindByName(query, page * PageSize(), PageSize(), slots);
+        }
+        float cellW = (area.width - (cols - 1) * GAP) / cols;
+        float cellH = (area.height - (rows - 1) * GAP) / rows;
+        for (size_t k = 0; k < slots.size(); ++k) {
+            rects.push_back({area.x + (k % cols) * (cellW + GAP), area.y + (k / cols) * (cellH + GAP), cellW, cellH});
+            labels.push_back(FitLabel(bank.At(slots[k]), (int)cellW - 16));
+        }
+    }
+
+    // Slot of the customer clicked this frame, or -1.
+    int Clicked(int disabledSlot = -1) const {
+        for (size_t k = 0; k < rects.size(); ++k)
+            if (IsButtonClicked(rects[k], slots[k] != disabledSlot)) return slots[k];
+        return -1;
+    }
+
+    void Draw(bool enabled, int activeSlot = -1, int disabledSlot = -1) const {
+        for (size_t k = 0; k < rects.size(); ++k) {
+            Color fill = slots[k] == activeSlot ? Color{170, 205, 240, 255} : LIGHTGRAY;
+            DrawButton(labels[k].c_str(), rects[k], fill, enabled && slots[k] != disabledSlot);
+        }
+        if (rects.empty()) DrawText(query.empty() ? "No customers yet" : "No matching customers", (int)area.x, (int)area.y + 10, 20, GRAY);
+    }
+
+private:
+    // "Name (Acc id)", with the name shortened to fit the cell.
+    static std::string FitLabel(const Customer& c, int width) {
+        std::string suffix = " (Acc " + std::to_string(c.id) + ")";
+        std::string name = c.name;
+        std::string label = name + suffix;
+        while (!name.empty() && MeasureText(label.c_str(), 20) > width) {
+            name.pop_back();
+            label = name + ".." + suffix;
+        }
+        return label;
+    }
+
+    std::string query;
+    size_t page = 0;
+    bool stale = true;
+    size_t builtSize = 0;
+};
+
+CustomerList customerList({20, 120, 880, 90}, 5, 2);
+CustomerList transferList({220, 255, 560, 275}, 2, 6);
+
+// Typed characters accepted by the search boxes.
+void EditSearch(std::string& text) {
+    for (int ch = GetCharPressed(); ch > 0; ch = GetCharPressed())
+        if (std::isalnum(ch) || ch == ' ')
+            if (text.size() < 20) text.push_back((char)ch);
+    if (IsKeyPressed(KEY_BACKSPACE) && !text.empty()) text.pop_back();
+}
+
+void DrawSearchBox(const std::string& text, Rectangle box, bool active) {
+    DrawRectangleRec(box, LIGHTGRAY);
+    DrawRectangleLinesEx(box, 2, active ? RED : BLACK);
+    if (text.empty()) DrawText("Search name or acc #", box.x + 8, box.y + (box.height - 18) / 2, 18, GRAY);
+    else DrawText(text.c_str(), box.x + 8, box.y + (box.height - 20) / 2, 20, BLACK);
+}
+
 // ---------- Main ----------
 int main() {
     const int W = 1000, H = 720;
     InitWindow(W, H, "Banking System (Raylib GUI)");
     SetTargetFPS(60);
+    message = RecoverLedger();
 
     while (!WindowShouldClose()) {
         // ===================================================================
@@ -145,7 +331,14 @@ int main() {
                         if (inputName.size() < 20) inputName.push_back((char)ch);
                 if (IsKeyPressed(KEY_BACKSPACE) && !inputName.empty()) inputName.pop_back();
             }
+            if (inputSearchActive) EditSearch(inputSearch);
+        } else {
+            EditSearch(transferSearch);
         }
+        customerList.SetQuery(inputSearch);
+        transferList.SetQuery(transferSearch);
+        customerList.Refresh();
+        transferList.Refresh();
 
         // --- Button Input ---
         if (transferMode) {
@@ -157,82 +350,87 @@ int main() {
                 message = "Transfer cancelled";
             }
 
-            int ty = 220;
-            float amtNow = ToFloat(inputAmount);
-            for (int i = 0; i < (int)customers.size(); ++i) {
-                if (i == transferSourceIndex) continue;
-                std::string label = customers[i].name + " (Acc " + std::to_string(customers[i].id) + ")";
-                int wBtn = MeasureText(label.c_str(), 20) + 40;
-                Rectangle targetBtnBounds = {240, (float)ty, (float)wBtn, 40};
-
-                if (IsButtonClicked(targetBtnBounds)) {
-                    std::string msg;
-                    if (transferSourceIndex >= 0) {
-                        Account& from = customers[transferSourceIndex].account;
-                        Account& to = customers[i].account;
-                        if (amtNow > 0) {
-                            from.Transfer(to, amtNow, msg);
-                            message = msg + " (to " + customers[i].name + ")";
-                        } else message = "Invalid transfer amount";
-                    }
-                    inputAmount.clear();
-                    transferMode = false;
-                    transferSourceIndex = -1;
+            if (IsButtonClicked({600, 205, 60, 36})) transferList.PrevPage();
+            if (IsButtonClicked({670, 205, 60, 36})) transferList.NextPage();
+
+            int target = transferList.Clicked(transferSourceIndex);
+            if (target >= 0) {
+                std::string msg;
+                Money amtNow = ToMoney(inputAmount);
+                if (transferSourceIndex >= 0) {
+                    Account& from = bank.At(transferSourceIndex).account;
+                    Account& to = bank.At(target).account;
+                    if (amtNow.IsPositive()) {
+                        Commit(MakeRecord(WalOp::Transfer, from.id, to.id, amtNow), msg);
+                        message = msg + " (to " + bank.At(target).name + ")";
+                    } else message = "Invalid transfer amount";
                 }
-                ty += 60;
+                inputAmount.clear();
+                transferMode = false;
+                transferSourceIndex = -1;
             }
         } else {
             // --- Main Screen Input Logic ---
-            float amt = ToFloat(inputAmount);
+            Money amt = ToMoney(inputAmount);
             Rectangle nameBox = {220, 65, 200, 40};
             Rectangle amountBox = {160, 285, 160, 40};
+            Rectangle searchBox = {620, 65, 180, 40};
             Rectangle addCustomerBtn = {440, 65, 160, 40};
             Rectangle depositBtn = {340, 285, 120, 40};
             Rectangle withdrawBtn = {470, 285, 120, 40};
             Rectangle transferBtn = {600, 285, 120, 40};
+            Rectangle statementBtn = {730, 285, 130, 40};
 
             if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
                 if (CheckCollisionPointRec(GetMousePosition(), nameBox)) {
-                    inputNameActive = true; inputAmountActive = false;
+                    inputNameActive = true; inputAmountActive = false; inputSearchActive = false;
                 } else if (CheckCollisionPointRec(GetMousePosition(), amountBox)) {
-                    inputAmountActive = true; inputNameActive = false;
+                    inputAmountActive = true; inputNameActive = false; inputSearchActive = false;
+                } else if (CheckCollisionPointRec(GetMousePosition(), searchBox)) {
+                    inputSearchActive = true; inputNameActive = false; inputAmountActive = false;
                 }
             }
 
             if (IsButtonClicked(addCustomerBtn)) {
-                if (!inputName.empty()) { AddCustomer(inputName); message = "Customer added: " + inputName; inputName.clear(); } 
+                if (!inputName.empty()) {
+                    WalRecord r = MakeRecord(WalOp::AddCustomer, 0);
+                    strncpy(r.name, inputName.c_str(), sizeof(r.name) - 1);
+                    Commit(r, message);
+                    inputName.clear();
+                }
                 else message = "Please enter a valid name";
             }
             
-            int x = 20, yBtn = 130;
-            for (int i = 0; i < (int)customers.size(); ++i) {
-                std::string label = customers[i].name + " (Acc " + std::to_string(customers[i].id) + ")";
-                int width = MeasureText(label.c_str(), 20) + 40;
-                if (IsButtonClicked({(float)x, (float)yBtn, (float)width, 40})) {
-                    activeCustomer = i; message = "Switched to " + customers[i].name;
-                }
-                x += width + 20; if (x > W - 200) { x = 20; yBtn += 50; }
+            if (IsButtonClicked({910, 120, 70, 40})) customerList.PrevPage();
+            if (IsButtonClicked({910, 170, 70, 40})) customerList.NextPage();
+            int picked = customerList.Clicked();
+            if (picked >= 0) {
+                activeCustomer = picked; message = "Switched to " + bank.At(picked).name;
             }
 
             if (activeCustomer != -1) {
-                Customer& c = customers[activeCustomer];
+                Customer& c = bank.At(activeCustomer);
                 if (IsButtonClicked(depositBtn)) {
-                    if (amt > 0) { c.account.Deposit(amt); message = "Deposit successful"; } 
+                    if (amt.IsPositive()) Commit(MakeRecord(WalOp::Deposit, c.id, 0, amt), message);
                     else message = "Invalid deposit amount";
                     inputAmount.clear();
                 }
                 if (IsButtonClicked(withdrawBtn)) {
                     std::string msg;
-                    if (amt > 0) c.account.Withdraw(amt, msg);
+                    if (amt.IsPositive()) Commit(MakeRecord(WalOp::Withdraw, c.id, 0, amt), msg);
                     else msg = "Invalid withdrawal amount";
                     message = msg;
                     inputAmount.clear();
                 }
                 if (IsButtonClicked(transferBtn)) {
-                    if (customers.size() > 1) {
+                    if (bank.Size() > 1) {
                         transferMode = true; transferSourceIndex = activeCustomer; message = "Select target account";
+                        transferSearch.clear();
                     } else message = "No other account to transfer";
                 }
+                if (IsButtonClicked(statementBtn)) { statementMode = !statementMode; historyScrollY = 0; }
+                if (statementMode && IsButtonClicked({850, 345, 60, 30})) statementView.Shift(-1);
+                if (statementMode && IsButtonClicked({920, 345, 60, 30}, statementView.offset < 0)) statementView.Shift(1);
             }
         }
 
@@ -240,6 +438,8 @@ int main() {
         // ===================================================================
         //  2. DRAWING PHASE
         // ===================================================================
+        customerList.Refresh();     // picks up customers or pages changed above
+        transferList.Refresh();
         BeginDrawing();
         ClearBackground(RAYWHITE);
 
@@ -253,18 +453,17 @@ int main() {
         DrawText(inputName.c_str(), nameBox.x + 8, nameBox.y + 10, 20, BLACK);
         DrawButton("Add Customer", {440, 65, 160, 40}, Color{200, 230, 200, 255}, !transferMode);
 
-        int x = 20, yBtn = 130;
-        for (int i = 0; i < (int)customers.size(); ++i) {
-            std::string label = customers[i].name + " (Acc " + std::to_string(customers[i].id) + ")";
-            int width = MeasureText(label.c_str(), 20) + 40;
-            DrawButton(label.c_str(), {(float)x, (float)yBtn, (float)width, 40}, LIGHTGRAY, !transferMode);
-            x += width + 20; if (x > W - 200) { x = 20; yBtn += 50; }
-        }
+        DrawSearchBox(inputSearch, {620, 65, 180, 40}, inputSearchActive && !transferMode);
+        DrawText(TextFormat("Page %zu/%zu", customerList.Page() + 1, customerList.PageCount()), 810, 76, 18, DARKGRAY);
+        customerList.Draw(!transferMode, activeCustomer);
+        DrawButton("<", {910, 120, 70, 40}, LIGHTGRAY, !transferMode && customerList.Page() > 0);
+        DrawButton(">", {910, 170, 70, 40}, LIGHTGRAY, !transferMode && customerList.Page() + 1 < customerList.PageCount());
 
         if (activeCustomer != -1) {
-            Customer& c = customers[activeCustomer];
+            Customer& c = bank.At(activeCustomer);
+            auto accountLock = bank.LockAccount(activeCustomer);   // balance and history may change under other producers
             DrawText(TextFormat("Active Customer: %s (ID %d)", c.name.c_str(), c.id), 20, 220, 22, BLACK);
-            DrawText(TextFormat("Balance: %.2f", c.account.balance), 20, 250, 22, DARKGREEN);
+            DrawText(TextFormat("Balance: %s", FormatMoney(c.account.balance).c_str()), 20, 250, 22, DARKGREEN);
 
             Rectangle amountBox = {160, 285, 160, 40};
             DrawRectangleRec(amountBox, LIGHTGRAY);
@@ -275,22 +474,29 @@ int main() {
             DrawButton("Deposit", {340, 285, 120, 40}, Color{173, 216, 230, 255}, !transferMode);
             DrawButton("Withdraw", {470, 285, 120, 40}, Color{255, 182, 193, 255}, !transferMode);
             DrawButton("Transfer", {600, 285, 120, 40}, Color{144, 238, 144, 255}, !transferMode);
-
-            DrawText("Transaction History:", 20, 350, 22, BLACK);
+            DrawButton(statementMode ? "History" : "Statement", {730, 285, 130, 40}, Color{255, 228, 181, 255}, !transferMode);
+
+            size_t panelRows = c.account.history.Size();
+            if (statementMode) {
+                statementView.Update(c.account);
+                panelRows = statementView.lines.size();
+                DrawText(statementView.title.c_str(), 20, 350, 22, BLACK);
+                DrawButton("<", {850, 345, 60, 30}, LIGHTGRAY, !transferMode);
+                DrawButton(">", {920, 345, 60, 30}, LIGHTGRAY, !transferMode && statementView.offset < 0);
+            } else {
+                DrawText("Transaction History:", 20, 350, 22, BLACK);
+            }
             Rectangle panel = {20, 380, 960, 250};
             DrawRectangleLinesEx(panel, 2, BLACK);
 
-            Rectangle panelContent = { panel.x, panel.y, panel.width, (float)c.account.history.size() * 28.0f };
+            Rectangle panelContent = { panel.x, panel.y, panel.width, (float)panelRows * HistoryView::ROW_HEIGHT };
             if(CheckCollisionPointRec(GetMousePosition(), panel)) historyScrollY -= GetMouseWheelMove() * 30.0f;
             if(historyScrollY > panelContent.height - panel.height) historyScrollY = panelContent.height - panel.height;
             if(historyScrollY < 0) historyScrollY = 0;
             
             BeginScissorMode((int)panel.x, (int)panel.y, (int)panel.width, (int)panel.height);
-                float y = panel.y + 5 - historyScrollY;
-                for (const auto& t : c.account.history) {
-                    DrawText(TextFormat("[%s] %s %.2f %s", t.timestamp.c_str(), t.type.c_str(), t.amount, t.details.c_str()), (int)panel.x + 10, (int)y, 18, DARKGRAY);
-                    y += 28.0f;
-                }
+                if (statementMode) statementView.Draw(panel, historyScrollY);
+                else historyView.Draw(c.account, panel, historyScrollY);
             EndScissorMode();
         }
 
@@ -302,20 +508,19 @@ int main() {
             DrawText("Select Account to Transfer", 220, 170, 24, DARKBLUE);
             DrawButton("X", {740, 150, 40, 40}, Color{255, 180, 180, 255});
             
-            int ty = 220;
-            for (int i = 0; i < (int)customers.size(); ++i) {
-                if (i == transferSourceIndex) continue;
-                std::string label = customers[i].name + " (Acc " + std::to_string(customers[i].id) + ")";
-                int wBtn = MeasureText(label.c_str(), 20) + 40;
-                DrawButton(label.c_str(), {240, (float)ty, (float)wBtn, 40}, LIGHTGRAY);
-                ty += 60;
-            }
+            DrawSearchBox(transferSearch, {220, 205, 300, 36}, true);
+            DrawText(TextFormat("%zu/%zu", transferList.Page() + 1, transferList.PageCount()), 530, 214, 18, DARKGRAY);
+            DrawButton("<", {600, 205, 60, 36}, LIGHTGRAY, transferList.Page() > 0);
+            DrawButton(">", {670, 205, 60, 36}, LIGHTGRAY, transferList.Page() + 1 < transferList.PageCount());
+            transferList.Draw(true, -1, transferSourceIndex);
         }
 
         if (!message.empty()) DrawText(message.c_str(), 20, H - 40, 22, RED);
+        if (bank.LogFailed()) DrawText("Write-ahead log error: changes are no longer saved", 20, H - 70, 20, MAROON);
         EndDrawing();
     }
 
+    bank.Close();
     CloseWindow();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,632 @@
+// Headless banking tools built on the core headers (no raylib).
+//   stress  hammers one TransactionEngine from many threads with random
+//           deposits, withdrawals and transfers, then checks that no money
+//           was created or lost and every balance matches its history.
+//   lookup  times id lookups, transfers by account number and name-prefix
+//           searches over a large customer store, checking every answer.
+//   replay  applies a CSV or binary file of operations in order and reports
+//           throughput, latency percentiles and final balances.
+//   gen     writes a random operation file for replay.
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BankingCore.h"
+
+// ---------- Audits ----------
+// Net effect of an account's history, which must equal its balance.
+static Money LedgerNet(const Ledger& h) {
+    Money net;
+    for (size_t i = 0; i < h.Size(); ++i) {
+        TxRow r = h.At(i);
+        if (r.type == TxType::Deposit || r.type == TxType::TransferIn) net += r.amount;
+        else net -= r.amount;
+    }
+    return net;
+}
+
+struct AuditResult {
+    Money total, transfersOut, transfersIn;
+    size_t mismatched = 0;
+};
+
+// Caller holds a consistent cut (TransactionEngine::Quiesce).
+static AuditResult Audit(const TransactionEngine& bank) {
+    AuditResult a;
+    for (size_t i = 0; i < bank.Size(); ++i) {
+        const Account& acc = bank.At(i).account;
+        a.total += acc.balance;
+        if (LedgerNet(acc.history) != acc.balance) a.mismatched++;
+        for (size_t k = 0; k < acc.history.Size(); ++k) {
+            TxRow r = acc.history.At(k);
+            if (r.type == TxType::TransferOut) a.transfersOut += r.amount;
+            else if (r.type == TxType::TransferIn) a.transfersIn += r.amount;
+        }
+    }
+    return a;
+}
+
+// ---------- Stress ----------
+struct StressOptions {
+    unsigned threads = std::thread::hardware_concurrency();
+    size_t accounts = 1000;
+    size_t opsPerThread = 100000;
+    int auditMs = 50;           // interval of the mid-run audits
+};
+
+struct ThreadTotals {
+    Money deposited, withdrawn;
+    size_t applied = 0, rejected = 0;
+};
+
+static bool RunStress(const StressOptions& opt) {
+    TransactionEngine bank;
+    const Money opening = Money::FromMajor(1000);
+    std::string msg;
+    for (size_t i = 0; i < opt.accounts; ++i) {
+        WalRecord r;
+        r.op = WalOp::AddCustomer;
+        std::snprintf(r.name, sizeof(r.name), "Stress %u", (unsigned)(i + 1));
+        bank.Apply(r, msg);
+        r = WalRecord();
+        r.op = WalOp::Deposit;
+        r.account = (int)i + 1;
+        r.amount = opening.minor;
+        bank.Apply(r, msg);
+    }
+    const Money initial = bank.TotalBalance();
+
+    std::vector<ThreadTotals> totals(opt.threads);
+    std::atomic<unsigned> running{opt.threads};
+    auto worker = [&](unsigned t) {
+        std::mt19937_64 rng(0x5eed + t);
+        std::uniform_int_distribution<int> pickAccount(1, (int)opt.accounts);
+        std::uniform_int_distribution<int64_t> pickAmount(1, 50000);
+        std::string msg;
+        ThreadTotals& mine = totals[t];
+        for (size_t k = 0; k < opt.opsPerThread; ++k) {
+            WalRecord r;
+            int dice = (int)(rng() % 100);
+            r.op = dice < 70 ? WalOp::Transfer : dice < 85 ? WalOp::Deposit : WalOp::Withdraw;
+            r.account = pickAccount(rng);
+            r.counterparty = r.op == WalOp::Transfer ? pickAccount(rng) : 0;
+            r.amount = pickAmount(rng);
+            r.time = (int64_t)k;
+            if (!bank.Apply(r, msg)) { mine.rejected++; continue; }
+            mine.applied++;
+            if (r.op == WalOp::Deposit) mine.deposited += Money::FromMinor(r.amount);
+            else if (r.op == WalOp::Withdraw) mine.withdrawn += Money::FromMinor(r.amount);
+        }
+        running--;
+    };
+
+    // Mid-run audits: at any consistent cut, every balance must match its
+    // history and transfers must net to zero.
+    size_t audits = 0, badAudits = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < opt.threads; ++t) pool.emplace_back(worker, t);
+    while (running > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(opt.auditMs));
+        bank.Quiesce([&] {
+            AuditResult a = Audit(bank);
+            audits++;
+            if (a.mismatched || a.transfersOut != a.transfersIn) badAudits++;
+        });
+    }
+    for (auto& th : pool) th.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ThreadTotals sum;
+    for (const ThreadTotals& t : totals) {
+        sum.deposited += t.deposited; sum.withdrawn += t.withdrawn;
+        sum.applied += t.applied; sum.rejected += t.rejected;
+    }
+    AuditResult final;
+    bank.Quiesce([&] { final = Audit(bank); });
+    Money expected = initial + sum.deposited - sum.withdrawn;
+
+    size_t ops = opt.opsPerThread * opt.threads;
+    std::printf("Threads:     %u\n", opt.threads);
+    std::printf("Accounts:    %zu\n", opt.accounts);
+    std::printf("Operations:  %zu (%zu applied, %zu rejected)\n", ops, sum.applied, sum.rejected);
+    std::printf("Throughput:  %.0f ops/sec (%.3f s)\n", secs > 0 ? ops / secs : 0.0, secs);
+    std::printf("Audits:      %zu mid-run, %zu failed\n", audits, badAudits);
+    std::printf("Total money: %s (expected %s)\n", FormatMoney(final.total).c_str(), FormatMoney(expected).c_str());
+    std::printf("Transfers:   out %s, in %s\n", FormatMoney(final.transfersOut).c_str(), FormatMoney(final.transfersIn).c_str());
+    bool ok = final.total == expected && final.transfersOut == final.transfersIn && final.mismatched == 0 && badAudits == 0;
+    if (final.mismatched) std::printf("%zu accounts disagree with their history\n", final.mismatched);
+    std::printf("%s\n", ok ? "PASS: money conserved" : "FAIL");
+    return ok;
+}
+
+// ---------- Lookup ----------
+struct LookupOptions {
+    size_t customers = 200000;
+    size_t queries = 1000000;
+};
+
+static double NsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static std::string RandomName(std::mt19937_64& rng) {
+    static const char* const syllables[] = {"an", "bel", "cor", "da", "el", "fin", "gar", "ho", "is", "jo",
+                                            "ka", "lu", "mar", "ne", "or", "pa", "qui", "ro", "sa", "ti"};
+    std::string name;
+    int n = 2 + (int)(rng() % 3);
+    for (int k = 0; k < n; ++k) name += syllables[rng() % 20];
+    name[0] = (char)std::toupper((unsigned char)name[0]);
+    return name;
+}
+
+static bool StartsWithFolded(const std::string& s, const std::string& prefix) {
+    if (s.size() < prefix.size()) return false;
+    for (size_t k = 0; k < prefix.size(); ++k)
+        if (std::tolower((unsigned char)s[k]) != std::tolower((unsigned char)prefix[k])) return false;
+    return true;
+}
+
+static bool RunLookup(const LookupOptions& opt) {
+    TransactionEngine bank;
+    std::mt19937_64 rng(0x1d5);
+    std::string msg;
+    bool ok = true;
+
+    // Sparse 9-digit account numbers, as an import from another system would have.
+    std::vector<int> ids;
+    ids.reserve(opt.customers);
+    auto t0 = std::chrono::steady_clock::now();
+    while (ids.size() < opt.customers) {
+        WalRecord r;
+        r.op = WalOp::AddCustomer;
+        r.account = 100000000 + (int)(rng() % 900000000);
+        std::snprintf(r.name, sizeof(r.name), "%s", RandomName(rng).c_str());
+        if (!bank.Apply(r, msg)) continue;      // number already taken
+        ids.push_back(r.account);
+        r = WalRecord();
+        r.op = WalOp::Deposit;
+        r.account = ids.back();
+        r.amount = Money::FromMajor(100).minor;
+        bank.Apply(r, msg);
+    }
+    double addNs = NsSince(t0) / opt.customers;
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        int slot = bank.IndexOf(ids[i]);
+        if (slot < 0 || bank.At(slot).id != ids[i]) { ok = false; break; }
+    }
+
+    std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+    size_t found = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < opt.queries; ++q) {
+        // Every other probe is a number that was never issued.
+        int id = (q & 1) ? ids[pick(rng)] : -(int)q - 1;
+        found += bank.IndexOf(id) >= 0;
+    }
+    double lookupNs = NsSince(t0) / opt.queries;
+    if (found != opt.queries / 2) ok = false;
+
+    size_t transfers = std::min<size_t>(opt.queries, 200000), applied = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < transfers; ++q) {
+        WalRecord r;
+        r.op = WalOp::Transfer;
+        r.account = ids[pick(rng)];
+        r.counterparty = ids[pick(rng)];
+        r.amount = 1 + (int64_t)(rng() % 500);
+        applied += bank.Apply(r, msg);
+    }
+    double transferNs = NsSince(t0) / transfers;
+    if (bank.TotalBalance() != Money::FromMinor(Money::FromMajor(100).minor * (int64_t)ids.size())) ok = false;
+
+    // First page of 20 for random 1-3 letter prefixes, checked against a scan.
+    // The first query folds the bulk-added names into the sorted index.
+    std::vector<int> page;
+    t0 = std::chrono::steady_clock::now();
+    bank.FindByName("", 0, 0, page);
+    double sortMs = NsSince(t0) / 1e6;
+    size_t searches = 2000, matches = 0;
+    double searchNs = 0;
+    for (size_t q = 0; q < searches; ++q) {
+        std::string prefix = RandomName(rng).substr(0, 1 + q % 3);
+        page.clear();
+        t0 = std::chrono::steady_clock::now();
+        size_t total = bank.FindByName(prefix, 0, 20, page);
+        searchNs += NsSince(t0);
+        matches += total;
+        for (size_t k = 0; k < page.size(); ++k) {
+            if (!StartsWithFolded(bank.At(page[k]).name, prefix)) ok = false;
+            if (k > 0 && bank.At(page[k - 1]).name > bank.At(page[k]).name) ok = false;
+        }
+        if (q % 200 == 0) {
+            size_t scan = 0;
+            for (size_t i = 0; i < bank.Size(); ++i) scan += StartsWithFolded(bank.At(i).name, prefix);
+            if (scan != total) ok = false;
+        }
+    }
+
+    std::printf("Customers:   %zu (add %.0f ns each)\n", opt.customers, addNs);
+    std::printf("Id lookup:   %.1f ns (%zu probes, half misses)\n", lookupNs, opt.queries);
+    std::printf("Transfer:    %.0f ns by account number (%zu of %zu applied)\n", transferNs, applied, transfers);
+    std::printf("Name prefix: %.1f us per first page (%zu searches, %.0f matches avg; initial sort %.0f ms)\n",
+                searchNs / searches / 1000, searches, (double)matches / searches, sortMs);
+    std::printf("%s\n", ok ? "PASS: every lookup agrees with a scan" : "FAIL");
+    return ok;
+}
+
+// ---------- Operation Files ----------
+// CSV: one operation per line; blank lines and '#' comments are skipped.
+//   add,<id>,<name>              id 0 takes the next free id
+//   deposit,<id>,<amount>
+//   withdraw,<id>,<amount>
+//   transfer,<from id>,<to id>,<amount>
+// Binary: consecutive 64-byte WalRecords (BankingWAL.h) with valid CRCs; a
+// write-ahead log segment (bank.wal.N) is accepted as is.
+static bool ParseId(const std::string& s, int32_t& id) {
+    if (s.empty() || s.size() > 10) return false;
+    long long v = 0;
+    for (char ch : s) {
+        if (ch < '0' || ch > '9') return false;
+        v = v * 10 + (ch - '0');
+    }
+    if (v > INT32_MAX) return false;
+    id = (int32_t)v;
+    return true;
+}
+
+static bool ParseCsvLine(const std::string& line, WalRecord& r) {
+    std::vector<std::string> f;
+    size_t start = 0;
+    for (;;) {
+        size_t comma = line.find(',', start);
+        std::string field = line.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        size_t a = field.find_first_not_of(" \t\r"), b = field.find_last_not_of(" \t\r");
+        f.push_back(a == std::string::npos ? "" : field.substr(a, b - a + 1));
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    Money amt;
+    r = WalRecord();
+    if (f[0] == "add" && f.size() == 3 && ParseId(f[1], r.account) && !f[2].empty() && f[2].size() < sizeof(r.name)) {
+        r.op = WalOp::AddCustomer;
+        std::memcpy(r.name, f[2].data(), f[2].size());
+        return true;
+    }
+    if ((f[0] == "deposit" || f[0] == "withdraw") && f.size() == 3 && ParseId(f[1], r.account) && ParseMoney(f[2], amt)) {
+        r.op = f[0] == "deposit" ? WalOp::Deposit : WalOp::Withdraw;
+        r.amount = amt.minor;
+        return true;
+    }
+    if (f[0] == "transfer" && f.size() == 4 && ParseId(f[1], r.account) && ParseId(f[2], r.counterparty)
+        && ParseMoney(f[3], amt)) {
+        r.op = WalOp::Transfer;
+        r.amount = amt.minor;
+        return true;
+    }
+    return false;
+}
+
+static bool ReadFile(const std::string& path, std::string& data) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    char buf[1 << 16];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) data.append(buf, n);
+    std::fclose(f);
+    return true;
+}
+
+// Format "auto" picks binary for a log segment or a .bin/.wal file, CSV otherwise.
+static bool LoadOps(const std::string& path, std::string format, std::vector<WalRecord>& ops, std::string& err) {
+    std::string data;
+    if (!ReadFile(path, data)) { err = "cannot read " + path; return false; }
+    bool segment = data.compare(0, 4, "BKWL") == 0;
+    if (format == "auto") {
+        size_t dot = path.rfind('.');
+        std::string ext = dot == std::string::npos ? "" : path.substr(dot);
+        format = segment || ext == ".bin" || path.find(".wal.") != std::string::npos ? "bin" : "csv";
+    }
+    if (format == "bin") {
+        size_t pos = segment ? 16 : 0;   // "BKWL" | u32 version | u64 segment
+        if ((data.size() - pos) % sizeof(WalRecord) != 0) { err = "binary file is not a whole number of records"; return false; }
+        ops.resize((data.size() - pos) / sizeof(WalRecord));
+        std::memcpy(ops.data(), data.data() + pos, data.size() - pos);
+        for (size_t i = 0; i < ops.size(); ++i)
+            if (ops[i].crc != RecordCrc(ops[i])) { err = "bad checksum in record " + std::to_string(i + 1); return false; }
+        return true;
+    }
+    if (format != "csv") { err = "unknown format " + format; return false; }
+    size_t lineNo = 0;
+    for (size_t pos = 0; pos < data.size();) {
+        size_t end = data.find('\n', pos);
+        if (end == std::string::npos) end = data.size();
+        std::string line = data.substr(pos, end - pos);
+        pos = end + 1;
+        lineNo++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        WalRecord r;
+        if (!ParseCsvLine(line.substr(first), r)) { err = path + ":" + std::to_string(lineNo) + ": cannot parse \"" + line + "\""; return false; }
+        ops.push_back(r);
+    }
+    return true;
+}
+
+// ---------- Replay ----------
+struct ReplayOptions {
+    std::string path;
+    std::string format = "auto";
+    std::string walBase;        // empty: in memory only
+    std::string jsonPath;
+    size_t show = 20;           // balances printed
+    int statementId = 0;        // account whose monthly statements are printed
+};
+
+// Nearest-rank percentile of an ascending vector.
+template <typename T>
+static T Percentile(const std::vector<T>& sorted, double p) {
+    if (sorted.empty()) return T{};
+    size_t rank = (size_t)std::ceil(p / 100.0 * sorted.size());
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+static std::string JsonEscape(const std::string& s) {
+    std::string out;
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') out += '\\';
+        out += ch;
+    }
+    return out;
+}
+
+// One line per calendar month from the account's first transaction to its
+// last, answered from the day buckets rather than by scanning the history.
+static bool PrintStatements(Bank& bank, int id) {
+    int slot = bank.IndexOf(id);
+    if (slot < 0) { std::fprintf(stderr, "no account %d\n", id); return false; }
+    auto lock = bank.LockAccount((size_t)slot);
+    Account& acc = bank.At((size_t)slot).account;
+    auto t0 = std::chrono::steady_clock::now();
+    const AccountStats& stats = acc.Stats();
+    double syncMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("Statements for %d (%s), %zu transactions on %zu days:\n", id, bank.At((size_t)slot).name.c_str(),
+                acc.history.Size(), stats.Days().size());
+    if (acc.history.Empty()) return true;
+    std::printf("  %-7s  %14s  %14s  %14s  %14s  %14s  %14s  %8s\n", "Month", "Opening", "Deposits", "Withdrawals",
+                "Transfers in", "Transfers out", "Closing", "Count");
+    t0 = std::chrono::steady_clock::now();
+    size_t months = 0;
+    int64_t last = acc.history.TimeAt(acc.history.Size() - 1);
+    for (int64_t month = LocalMonthStart(acc.history.TimeAt(0)); month <= last; month = LocalMonthStart(month, 1), ++months) {
+        int64_t next = LocalMonthStart(month, 1);
+        FlowTotals t = stats.Range(month, next);
+        char label[16];
+        struct tm local = LocalTime(month);
+        strftime(label, sizeof(label), "%Y-%m", &local);
+        std::printf("  %-7s  %14s  %14s  %14s  %14s  %14s  %14s  %8zu\n", label,
+                    FormatMoney(BalanceAt(acc.history, month - 1)).c_str(), FormatMoney(t.deposits).c_str(),
+                    FormatMoney(t.withdrawals).c_str(), FormatMoney(t.transfersIn).c_str(),
+                    FormatMoney(t.transfersOut).c_str(), FormatMoney(BalanceAt(acc.history, next - 1)).c_str(), t.count);
+    }
+    double queryUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("  (first sync %.3f ms, %zu months in %.1f us)\n", syncMs, months, queryUs);
+    return true;
+}
+
+static bool RunReplay(const ReplayOptions& opt) {
+    std::vector<WalRecord> ops;
+    std::string err;
+    if (!LoadOps(opt.path, opt.format, ops, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return false; }
+
+    // Without --wal the bank is never opened and nothing touches the disk.
+    Bank bank(opt.walBase.empty() ? "bank" : opt.walBase);
+    if (!opt.walBase.empty() && !bank.Open().persistent) {
+        std::fprintf(stderr, "cannot open write-ahead log %s.wal\n", opt.walBase.c_str());
+        return false;
+    }
+    const time_t now = time(nullptr);
+    std::vector<uint32_t> latencyNs(ops.size());
+    size_t applied = 0, rejected = 0;
+    std::string msg;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ops.size(); ++i) {
+        WalRecord r = ops[i];
+        if (r.time == 0) r.time = (int64_t)now;
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = bank.Commit(r, msg);
+        auto t1 = std::chrono::steady_clock::now();
+        latencyNs[i] = (uint32_t)std::min<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count(), UINT32_MAX);
+        if (ok) applied++;
+        else if (rejected++ < 5) std::fprintf(stderr, "operation %zu rejected: %s\n", i + 1, msg.c_str());
+    }
+    double applySecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!opt.walBase.empty()) bank.Flush();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencyNs.begin(), latencyNs.end());
+    const double pcts[] = {50, 90, 99, 99.9};
+    Money total = bank.TotalBalance();
+    double txPerSec = secs > 0 ? ops.size() / secs : 0.0;
+
+    std::printf("Operations:  %zu (%zu applied, %zu rejected)\n", ops.size(), applied, rejected);
+    std::printf("Throughput:  %.0f tx/sec (%.3f s", txPerSec, secs);
+    if (!opt.walBase.empty()) std::printf(", %.3f s before the final fsync", applySecs);
+    std::printf(")\n");
+    std::printf("Latency:     p50 %u ns, p90 %u ns, p99 %u ns, p99.9 %u ns, max %u ns\n",
+                Percentile(latencyNs, 50), Percentile(latencyNs, 90), Percentile(latencyNs, 99),
+                Percentile(latencyNs, 99.9), latencyNs.empty() ? 0u : latencyNs.back());
+    std::printf("Accounts:    %zu, total balance %s\n", bank.Size(), FormatMoney(total).c_str());
+    size_t shown = std::min(opt.show, bank.Size());
+    for (size_t i = 0; i < shown; ++i)
+        std::printf("  %10d  %-24s %16s\n", bank.At(i).id, bank.At(i).name.c_str(), FormatMoney(bank.At(i).account.balance).c_str());
+    if (shown < bank.Size()) std::printf("  ... %zu more (--show n)\n", bank.Size() - shown);
+    if (opt.statementId != 0 && !PrintStatements(bank, opt.statementId)) return false;
+
+    if (!opt.jsonPath.empty()) {
+        FILE* f = opt.jsonPath == "-" ? stdout : std::fopen(opt.jsonPath.c_str(), "w");
+        if (!f) { std::fprintf(stderr, "cannot write %s\n", opt.jsonPath.c_str()); return false; }
+        std::fprintf(f, "{\n  \"file\": \"%s\",\n  \"durable\": %s,\n  \"operations\": %zu,\n  \"applied\": %zu,\n  \"rejected\": %zu,\n",
+                     JsonEscape(opt.path).c_str(), opt.walBase.empty() ? "false" : "true", ops.size(), applied, rejected);
+        std::fprintf(f, "  \"seconds\": %.6f,\n  \"tx_per_sec\": %.1f,\n  \"latency_ns\": {", secs, txPerSec);
+        for (double p : pcts) std::fprintf(f, "\"p%g\": %u, ", p, Percentile(latencyNs, p));
+        std::fprintf(f, "\"max\": %u},\n", latencyNs.empty() ? 0u : latencyNs.back());
+        std::fprintf(f, "  \"accounts\": %zu,\n  \"total_balance\": \"%s\",\n  \"balances\": [\n", bank.Size(), FormatMoney(total).c_str());
+        for (size_t i = 0; i < shown; ++i)
+            std::fprintf(f, "    {\"id\": %d, \"name\": \"%s\", \"balance\": \"%s\"}%s\n", bank.At(i).id,
+                         JsonEscape(bank.At(i).name).c_str(), FormatMoney(bank.At(i).account.balance).c_str(), i + 1 < shown ? "," : "");
+        std::fprintf(f, "  ]\n}\n");
+        if (f != stdout) std::fclose(f);
+    }
+    return true;
+}
+
+// ---------- Gen ----------
+struct GenOptions {
+    std::string path;
+    size_t accounts = 1000;
+    size_t ops = 1000000;
+    uint64_t seed = 1;
+    bool binary = false;
+};
+
+// Opens `accounts` accounts with 1000.00 each, then a 70/15/15 mix of
+// transfers, deposits and withdrawals between random accounts. Binary records
+// are stamped evenly over the past year so statements have months to show;
+// CSV has no time column and replay stamps those with the current time.
+static bool RunGen(const GenOptions& opt) {
+    FILE* f = std::fopen(opt.path.c_str(), "wb");
+    if (!f) { std::fprintf(stderr, "cannot write %s\n", opt.path.c_str()); return false; }
+    std::mt19937_64 rng(opt.seed);
+    std::uniform_int_distribution<int> pickAccount(1, (int)opt.accounts);
+    std::uniform_int_distribution<int64_t> pickAmount(1, 50000);
+    uint64_t lsn = 0;
+    const int64_t end = (int64_t)time(nullptr), span = 365 * 86400;
+    const size_t records = 2 * opt.accounts + opt.ops;
+    auto emit = [&](WalRecord r) {
+        if (opt.binary) {
+            r.time = end - span + (int64_t)((double)span * lsn / records);
+            r.lsn = ++lsn;
+            r.crc = RecordCrc(r);
+            std::fwrite(&r, sizeof r, 1, f);
+            return;
+        }
+        char amount[32];
+        FormatMoney(Money::FromMinor(r.amount), amount, sizeof amount);
+        switch (r.op) {
+            case WalOp::AddCustomer: std::fprintf(f, "add,%d,%s\n", r.account, r.name); break;
+            case WalOp::Deposit: std::fprintf(f, "deposit,%d,%s\n", r.account, amount); break;
+            case WalOp::Withdraw: std::fprintf(f, "withdraw,%d,%s\n", r.account, amount); break;
+            case WalOp::Transfer: std::fprintf(f, "transfer,%d,%d,%s\n", r.account, r.counterparty, amount); break;
+        }
+    };
+    if (!opt.binary) std::fprintf(f, "# banking_tool gen --accounts %zu --ops %zu --seed %llu\n", opt.accounts, opt.ops, (unsigned long long)opt.seed);
+    for (size_t i = 1; i <= opt.accounts; ++i) {
+        WalRecord r = MakeRecord(WalOp::AddCustomer, (int)i, 0, Money(), 0);
+        std::snprintf(r.name, sizeof(r.name), "%s", RandomName(rng).c_str());
+        emit(r);
+        emit(MakeRecord(WalOp::Deposit, (int)i, 0, Money::FromMajor(1000), 0));
+    }
+    for (size_t k = 0; k < opt.ops; ++k) {
+        int dice = (int)(rng() % 100);
+        WalOp op = dice < 70 ? WalOp::Transfer : dice < 85 ? WalOp::Deposit : WalOp::Withdraw;
+        int from = pickAccount(rng);
+        int to = op == WalOp::Transfer ? pickAccount(rng) : 0;
+        emit(MakeRecord(op, from, to, Money::FromMinor(pickAmount(rng)), 0));
+    }
+    bool ok = std::fclose(f) == 0;
+    if (!ok) std::fprintf(stderr, "cannot write %s\n", opt.path.c_str());
+    return ok;
+}
+
+// ---------- Driver ----------
+static void PrintUsage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s stress [-j threads] [--accounts n] [--ops n] [--audit-ms n]\n"
+        "       %s lookup [--customers n] [--queries n]\n"
+        "       %s replay ops.csv|ops.bin [--format auto|csv|bin] [--wal base] [--show n] [--json out.json]\n"
+        "                [--statement id]\n"
+        "       %s gen out.csv|out.bin [--accounts n] [--ops n] [--seed n]\n"
+        "  stress  concurrent deposits/withdrawals/transfers against one engine;\n"
+        "          --ops is per thread. Exits with 3 if money is not conserved.\n"
+        "  lookup  id, account-number transfer and name-prefix lookups over a\n"
+        "          large store. Exits with 3 if any answer is wrong.\n"
+        "  replay  applies the operations in file order; --wal also logs them durably\n"
+        "          under <base>.snap/<base>.wal.N. --json writes the report ('-' for stdout);\n"
+        "          --statement prints an account's monthly statements.\n"
+        "  gen     random workload for replay (binary when the name ends in .bin).\n",
+        argv0, argv0, argv0, argv0);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { PrintUsage(argv[0]); return 2; }
+    std::string cmd = argv[1];
+    if (cmd == "stress") {
+        StressOptions opt;
+        for (int i = 2; i < argc; ++i) {
+            std::string a = argv[i];
+            const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!v) { PrintUsage(argv[0]); return 2; }
+            if (a == "-j") opt.threads = (unsigned)std::atoi(v);
+            else if (a == "--accounts") opt.accounts = (size_t)std::atol(v);
+            else if (a == "--ops") opt.opsPerThread = (size_t)std::atol(v);
+            else if (a == "--audit-ms") opt.auditMs = std::atoi(v);
+            else { PrintUsage(argv[0]); return 2; }
+            ++i;
+        }
+        if (opt.threads == 0) opt.threads = 1;
+        if (opt.accounts < 2) opt.accounts = 2;
+        if (opt.auditMs < 1) opt.auditMs = 1;
+        return RunStress(opt) ? 0 : 3;
+    }
+    if (cmd == "lookup") {
+        LookupOptions opt;
+        for (int i = 2; i < argc; ++i) {
+            std::string a = argv[i];
+            const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!v) { PrintUsage(argv[0]); return 2; }
+            if (a == "--customers") opt.customers = (size_t)std::atol(v);
+            else if (a == "--queries") opt.queries = (size_t)std::atol(v);
+            else { PrintUsage(argv[0]); return 2; }
+            ++i;
+        }
+        if (opt.customers < 2) opt.customers = 2;
+        if (opt.queries < 2) opt.queries = 2;
+        return RunLookup(opt) ? 0 : 3;
+    }
+    if (cmd == "replay" || cmd == "gen") {
+        if (argc < 3) { PrintUsage(argv[0]); return 2; }
+        ReplayOptions ropt;
+        GenOptions gopt;
+        ropt.path = gopt.path = argv[2];
+        gopt.binary = gopt.path.size() > 4 && gopt.path.compare(gopt.path.size() - 4, 4, ".bin") == 0;
+        for (int i = 3; i < argc; ++i) {
+            std::string a = argv[i];
+            const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!v) { PrintUsage(argv[0]); return 2; }
+            if (cmd == "replay" && a == "--format") ropt.format = v;
+            else if (cmd == "replay" && a == "--wal") ropt.walBase = v;
+            else if (cmd == "replay" && a == "--show") ropt.show = (size_t)std::atol(v);
+            else if (cmd == "replay" && a == "--json") ropt.jsonPath = v;
+            else if (cmd == "replay" && a == "--statement") ropt.statementId = std::atoi(v);
+            else if (cmd == "gen" && a == "--accounts") gopt.accounts = (size_t)std::atol(v);
+            else if (cmd == "gen" && a == "--ops") gopt.ops = (size_t)std::atol(v);
+            else if (cmd == "gen" && a == "--seed") gopt.seed = (uint64_t)std::strtoull(v, nullptr, 10);
+            else { PrintUsage(argv[0]); return 2; }
+            ++i;
+        }
+        if (gopt.accounts < 2) gopt.accounts = 2;
+        if (cmd == "gen") return RunGen(gopt) ? 0 : 1;
+        return RunReplay(ropt) ? 0 : 1;
+    }
+    PrintUsage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,313 @@
+// Write-ahead log for the banking ledger: fixed-size binary records appended
+// by the GUI, group-committed with one fsync per batch by a background
+// thread, plus snapshots that bound replay time. No raylib dependency.
+#pragma once
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// ------------------- Records -------------------
+enum class WalOp : uint8_t { AddCustomer=1, Deposit, Withdraw, Transfer };
+
+// 64 bytes on disk, written as-is (little-endian hosts). `crc` covers every
+// byte before it, so a torn write at the tail of the log is detected.
+struct WalRecord {
+    uint64_t lsn=0;             // log sequence number, 1-based and gap-free
+    int64_t time=0;             // epoch seconds when the operation happened
+    int64_t amount=0;           // minor units (see Money)
+    WalOp op=WalOp::Deposit;
+    uint8_t pad[3]{};
+    int32_t account=0;          // acting account (the new id for AddCustomer)
+    int32_t counterparty=0;     // transfer target, 0 otherwise
+    char name[24]{};            // AddCustomer only, NUL-terminated
+    uint32_t crc=0;
+};
+static_assert(sizeof(WalRecord)==64, "WalRecord must stay 64 bytes");
+
+inline uint32_t Crc32(const void *data, size_t len, uint32_t crc=0) {
+    static const std::array<uint32_t,256> table=[]{
+        std::array<uint32_t,256> t{};
+        for (uint32_t i=0;i<256;i++) {
+            uint32_t c=i;
+            for (int k=0;k<8;k++) c=(c&1) ? 0xEDB88320u^(c>>1) : c>>1;
+            t[i]=c;
+        }
+        return t;
+    }();
+    const uint8_t *p=(const uint8_t*)data;
+    crc=~crc;
+    for (size_t i=0;i<len;i++) crc=table[(crc^p[i])&0xFF]^(crc>>8);
+    return ~crc;
+}
+
+inline uint32_t RecordCrc(const WalRecord &r) { return Crc32(&r,offsetof(WalRecord,crc)); }
+
+// Flushes stdio buffers and forces the file's data to stable storage.
+inline bool SyncFile(FILE *f) {
+    if (std::fflush(f)!=0) return false;
+#if defined(_WIN32)
+    return _commit(_fileno(f))==0;
+#elif defined(__APPLE__)
+    return fsync(fileno(f))==0;
+#else
+    return fdatasync(fileno(f))==0;
+#endif
+}
+
+// ------------------- Write-Ahead Log -------------------
+// Files, for base name "bank":
+//   bank.snap    "BKSN" | u32 version | u64 lsn | u64 first segment | u64 size
+//                | u32 crc | snapshot blob (opaque to the log; it may refer
+//                to other files written before it, such as a ledger file)
+//   bank.wal.N   "BKWL" | u32 version | u64 N | WalRecord...
+// The snapshot covers every record up to `lsn`; replay resumes at its first
+// segment. A checkpoint rotates to a new segment, writes the snapshot to a
+// temporary file, renames it into place and only then deletes the segments
+// it covers, so a crash at any point leaves a recoverable pair.
+class WriteAheadLog {
+public:
+    static constexpr uint32_t VERSION = 6;   // 2: integer amounts, 3: columnar snapshot history, 4: mapped ledger file, 5: running balances, 6: ledger segments
+
+    explicit WriteAheadLog(std::string base="bank") : base(std::move(base)) {}
+    ~WriteAheadLog() { Close(); }
+
+    WriteAheadLog(const WriteAheadLog&)=delete;
+    WriteAheadLog &operator=(const WriteAheadLog&)=delete;
+
+    // Startup, step 1: reads the latest snapshot blob, if any.
+    bool LoadSnapshot(std::string &blob) {
+        FILE *f=std::fopen(SnapshotPath().c_str(),"rb");
+        if (!f) return false;
+        char magic[4];
+        uint32_t version=0, crc=0;
+        uint64_t lsn=0, first=0, size=0;
+        bool ok=std::fread(magic,1,4,f)==4 && std::memcmp(magic,"BKSN",4)==0
+            && Read(f,version) && version==VERSION && Read(f,lsn) && Read(f,first)
+            && Read(f,size) && Read(f,crc);
+        if (ok) {
+            blob.resize(size);
+            ok=std::fread(&blob[0],1,size,f)==size && Crc32(blob.data(),size)==crc;
+        }
+        std::fclose(f);
+        if (!ok) { blob.clear(); return false; }
+        snapshotLsn=lsn; firstSegment=first;
+        // Segments left behind by a crash between publishing a snapshot and
+        // deleting what it covers.
+        for (uint64_t n=first-1;n>0 && std::remove(SegmentPath(n).c_str())==0;n--) {}
+        return true;
+    }
+
+    // Startup, step 2: feeds every logged record newer than the snapshot to
+    // `apply`, in order. A torn or corrupt record ends its segment: it was
+    // never acknowledged as durable, and the next segment (opened after the
+    // restart) continues from the same LSN. Replay stops at the first gap.
+    size_t Replay(const std::function<void(const WalRecord&)> &apply) {
+        size_t applied=0;
+        uint64_t expect=snapshotLsn+1;
+        uint64_t seg=firstSegment;
+        for (bool gap=false;!gap;seg++) {
+            FILE *f=std::fopen(SegmentPath(seg).c_str(),"rb");
+            if (!f) break;
+            WalRecord r;
+            if (ReadSegmentHeader(f,seg))
+                while (std::fread(&r,sizeof r,1,f)==1 && r.crc==RecordCrc(r)) {
+                    if (r.lsn<expect) continue;   // already in the snapshot
+                    if (r.lsn!=expect) { gap=true; break; }
+                    apply(r); applied++; expect++;
+                }
+            std::fclose(f);
+        }
+        nextLsn=expect;
+        durableLsn=expect-1;   // everything replayed is on disk already
+        segment=seg;
+        return applied;
+    }
+
+    // Startup, step 3: opens a fresh segment and starts the commit thread.
+    // Until this succeeds, Append() is a no-op and the ledger is memory-only.
+    bool Start() {
+        if (writer.joinable()) return true;
+        if (!OpenSegment(segment)) return false;
+        writer=std::thread([this]{ Run(); });
+        return true;
+    }
+
+    bool Running() const { return writer.joinable(); }
+
+    // Assigns the next LSN and queues the record; returns the LSN. The
+    // record is durable once DurableLsn() reaches it.
+    uint64_t Append(WalRecord rec) {
+        if (!Running()) return 0;
+        std::lock_guard<std::mutex> lk(m);
+        rec.lsn=nextLsn++;
+        rec.crc=RecordCrc(rec);
+        pending.push_back(rec);
+        sinceCheckpoint++;
+        cv.notify_one();
+        return rec.lsn;
+    }
+
+    // Produces the snapshot blob on the commit thread, given the LSN it
+    // covers; returning false fails the log like a write error.
+    using SnapshotBuilder=std::function<bool(uint64_t lsn, std::string &blob)>;
+
+    // Queues a snapshot covering every record appended so far. `build` runs
+    // on the commit thread, so it must only use state it owns or that stays
+    // unchanged; a newer request replaces an unbuilt one.
+    void Checkpoint(SnapshotBuilder build) {
+        if (!Running()) return;
+        std::lock_guard<std::mutex> lk(m);
+        checkpointBuild=std::move(build);
+        checkpointLsn=nextLsn-1;
+        checkpointPending=true;
+        sinceCheckpoint=0;
+        cv.notify_one();
+    }
+
+    // Blocks until everything appended so far is on disk.
+    void Flush() {
+        std::unique_lock<std::mutex> lk(m);
+        uint64_t target=nextLsn-1;
+        done.wait(lk,[&]{ return !Running() || failed || (durableLsn>=target && !checkpointPending); });
+    }
+
+    void Close() {
+        if (!Running()) return;
+        { std::lock_guard<std::mutex> lk(m); stopping=true; }
+        cv.notify_one();
+        writer.join();
+        if (file) { std::fclose(file); file=nullptr; }
+    }
+
+    uint64_t DurableLsn() { std::lock_guard<std::mutex> lk(m); return durableLsn; }
+    size_t RecordsSinceCheckpoint() { std::lock_guard<std::mutex> lk(m); return sinceCheckpoint; }
+    bool Failed() { std::lock_guard<std::mutex> lk(m); return failed; }
+
+private:
+    template <typename T>
+    static bool Read(FILE *f, T &v) { return std::fread(&v,sizeof v,1,f)==1; }
+
+    std::string SnapshotPath() const { return base+".snap"; }
+    std::string SegmentPath(uint64_t n) const { return base+".wal."+std::to_string(n); }
+
+    static bool ReadSegmentHeader(FILE *f, uint64_t seg) {
+        char magic[4];
+        uint32_t version=0;
+        uint64_t n=0;
+        return std::fread(magic,1,4,f)==4 && std::memcmp(magic,"BKWL",4)==0
+            && Read(f,version) && version==VERSION && Read(f,n) && n==seg;
+    }
+
+    bool OpenSegment(uint64_t n) {
+        FILE *f=std::fopen(SegmentPath(n).c_str(),"wb");
+        if (!f) return false;
+        std::fwrite("BKWL",1,4,f);
+        std::fwrite(&VERSION,sizeof VERSION,1,f);
+        std::fwrite(&n,sizeof n,1,f);
+        if (!SyncFile(f)) { std::fclose(f); return false; }
+        file=f; segment=n;
+        return true;
+    }
+
+    bool WriteRecords(const WalRecord *recs, size_t count) {
+        return count==0 || (std::fwrite(recs,sizeof(WalRecord),count,file)==count && SyncFile(file));
+    }
+
+    // Runs on the commit thread: finishes the current segment, switches to
+    // the next one, publishes the snapshot and drops the covered segments.
+    bool WriteCheckpoint(const std::string &blob, uint64_t lsn) {
+        uint64_t old=segment;
+        std::fclose(file); file=nullptr;
+        if (!OpenSegment(old+1)) return false;
+        std::string tmp=SnapshotPath()+".tmp";
+        FILE *f=std::fopen(tmp.c_str(),"wb");
+        if (!f) return false;
+        uint64_t size=blob.size();
+        uint32_t crc=Crc32(blob.data(),blob.size());
+        std::fwrite("BKSN",1,4,f);
+        std::fwrite(&VERSION,sizeof VERSION,1,f);
+        std::fwrite(&lsn,sizeof lsn,1,f);
+        std::fwrite(&segment,sizeof segment,1,f);
+        std::fwrite(&size,sizeof size,1,f);
+        std::fwrite(&crc,sizeof crc,1,f);
+        std::fwrite(blob.data(),1,blob.size(),f);
+        bool ok=SyncFile(f);
+        ok=std::fclose(f)==0 && ok;
+#if defined(_WIN32)
+        if (ok) std::remove(SnapshotPath().c_str());   // rename() won't replace on Windows
+#endif
+        if (!ok || std::rename(tmp.c_str(),SnapshotPath().c_str())!=0) return false;
+        for (uint64_t n=firstSegment;n<=old;n++) std::remove(SegmentPath(n).c_str());
+        firstSegment=segment;
+        return true;
+    }
+
+    // Group commit: whatever was appended while the previous fsync ran goes
+    // out as one write and one fsync.
+    void Run() {
+        std::vector<WalRecord> batch;
+        for (;;) {
+            SnapshotBuilder build;
+            uint64_t cpLsn=0;
+            bool cp=false, stop;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                cv.wait(lk,[this]{ return stopping || !pending.empty() || checkpointPending; });
+                batch.swap(pending);
+                if ((cp=checkpointPending)) { build.swap(checkpointBuild); cpLsn=checkpointLsn; }
+                stop=stopping;
+            }
+            bool ok=!failed;
+            if (ok) {
+                // Records up to the checkpoint LSN belong to the old segment.
+                size_t split=batch.size();
+                if (cp) {
+                    split=0;
+                    while (split<batch.size() && batch[split].lsn<=cpLsn) split++;
+                }
+                ok=WriteRecords(batch.data(),split);
+                std::string blob;
+                if (ok && cp) ok=build(cpLsn,blob) && WriteCheckpoint(blob,cpLsn);
+                if (ok) ok=WriteRecords(batch.data()+split,batch.size()-split);
+            }
+            {
+                std::lock_guard<std::mutex> lk(m);
+                if (!ok) failed=true;
+                else if (!batch.empty()) durableLsn=batch.back().lsn;
+                if (cp && !checkpointBuild) checkpointPending=false;   // unless a newer one was queued meanwhile
+            }
+            done.notify_all();
+            batch.clear();
+            if (stop) {
+                std::lock_guard<std::mutex> lk(m);
+                if (pending.empty() && !checkpointPending) return;
+            }
+        }
+    }
+
+    std::string base;
+    FILE *file=nullptr;
+    uint64_t segment=1, firstSegment=1, snapshotLsn=0;
+
+    std::mutex m;
+    std::condition_variable cv, done;
+    std::vector<WalRecord> pending;
+    SnapshotBuilder checkpointBuild;
+    uint64_t nextLsn=1, durableLsn=0, checkpointLsn=0;
+    size_t sinceCheckpoint=0;
+    bool checkpointPending=false, stopping=false, failed=false;
+    std::thread writer;
+};
@@ -0,0 +1,181 @@
+// Text credential store: users.txt read once into a CredentialIndex
+// (LoginIndex.h) so lookups never touch the file again, with registrations
+// appended through one buffered writer; and the importer that moves it into
+// the binary table (LoginTable.h) the login form now uses. Passwords are
+// stored as scrypt credentials (LoginHash.h). Shared by the GUI and
+// LoginTool.cpp; no raylib dependency.
+#pragma once
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "LoginHash.h"
+#include "LoginIndex.h"
+#include "LoginTable.h"
+
+// ---------- users.txt ----------
+// std::isspace in the "C" locale, which is what `infile >> u` splits on.
+inline bool IsSpace(char ch) { return ch == ' ' || (ch >= '\t' && ch <= '\r'); }
+
+// Whole file into `buf`; a missing file reads as empty.
+inline bool ReadWholeFile(const std::string& path, std::vector<char>& buf) {
+    buf.clear();
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return true;
+    char chunk[1 << 16];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof chunk, f)) > 0) buf.insert(buf.end(), chunk, chunk + n);
+    bool ok = !std::ferror(f);
+    std::fclose(f);
+    return ok;
+}
+
+// Calls fn(username, credential) for each whitespace-separated pair, like
+// the old `while (infile >> u >> p)` loop.
+template <typename Fn>
+void ParseUsersText(std::string_view text, Fn fn) {
+    std::string_view token[2];
+    size_t have = 0;
+    for (size_t i = 0; i < text.size();) {
+        while (i < text.size() && IsSpace(text[i])) i++;
+        size_t start = i;
+        while (i < text.size() && !IsSpace(text[i])) i++;
+        if (i == start) break;
+        token[have++] = text.substr(start, i - start);
+        if (have == 2) { fn(token[0], token[1]); have = 0; }
+    }
+}
+
+// ---------- User Store ----------
+// users.txt holds whitespace-separated "username credential" pairs, one per
+// line; the credential is a HashPassword() string, or the plain password on
+// lines written before hashing. When a name appears twice the first pair
+// wins, as it did when every call scanned the file from the top.
+class UserStore {
+public:
+    explicit UserStore(std::string path = "users.txt") : path(path) {}
+    ~UserStore() { Close(); }
+
+    UserStore(const UserStore&) = delete;
+    UserStore& operator=(const UserStore&) = delete;
+
+    // Reads the file into the index; a missing file is an empty store.
+    // Register() and Login() call it on first use.
+    bool Load() {
+        if (loaded) return true;
+        index.Clear();
+        std::vector<char> buf;
+        if (!ReadWholeFile(path, buf)) return false;
+        index.Reserve(buf.size() / 20 + 1);   // ~20 bytes per line
+        ParseUsersText(std::string_view(buf.data(), buf.size()),
+                       [&](std::string_view u, std::string_view c) { index.Insert(u, c); });
+        needsNewline = !buf.empty() && buf.back() != '\n';
+        loaded = true;
+        return true;
+    }
+
+    // Adds the user to the index and queues its line; false if the name is
+    // taken or the file can't be opened for appending. The line reaches the
+    // file on Flush(), Close() or when the writer's buffer fills.
+    // `credential` is stored as given: hash the password first.
+    bool Register(const std::string& username, const std::string& credential) {
+        if (!Load()) return false;
+        std::string_view existing;
+        if (index.Find(username, existing)) return false;
+        if (!out && !OpenWriter()) return false;
+        if (needsNewline) std::fputc('\n', out);
+        needsNewline = false;
+        std::fprintf(out, "%s %s\n", username.c_str(), credential.c_str());
+        index.Insert(username, credential);
+        return true;
+    }
+
+    // The stored credential, for checking on another thread (AuthWorkers).
+    bool Find(const std::string& username, std::string& credential) {
+        std::string_view stored;
+        if (!Load() || !index.Find(username, stored)) return false;
+        credential.assign(stored.data(), stored.size());
+        return true;
+    }
+
+    // Checks the password on the calling thread: costs one KDF run.
+    bool Login(const std::string& username, const std::string& password) {
+        std::string stored;
+        return Find(username, stored) && VerifyPassword(password, stored);
+    }
+
+    bool Exists(const std::string& username) {
+        std::string_view stored;
+        return Load() && index.Find(username, stored);
+    }
+
+    // Hands queued registrations to the OS.
+    bool Flush() { return !out || std::fflush(out) == 0; }
+
+    void Close() {
+        if (out) std::fclose(out);
+        out = nullptr;
+    }
+
+    size_t Size() const { return index.Size(); }
+    const CredentialIndex& Index() const { return index; }
+
+private:
+    bool OpenWriter() {
+        out = std::fopen(path.c_str(), "ab");
+        if (out) std::setvbuf(out, nullptr, _IOFBF, 1 << 16);
+        return out != nullptr;
+    }
+
+    std::string path;
+    CredentialIndex index;
+    FILE* out = nullptr;
+    bool loaded = false;
+    bool needsNewline = false;  // the file's last line has no line break yet
+};
+
+// ---------- Import ----------
+struct ImportResult {
+    size_t imported = 0;
+    size_t duplicates = 0;      // already in the table, or repeated in the file
+    size_t tooLong = 0;         // name or credential doesn't fit a slot
+    bool ok = false;
+};
+
+// Copies users.txt into `table` as it stands; plain-text passwords stay
+// plain until their owner next logs in (see NeedsRehash). Syncs once at
+// the end.
+inline ImportResult ImportUsersText(const std::string& textPath, CredentialTable& table) {
+    ImportResult r;
+    std::vector<char> buf;
+    if (!ReadWholeFile(textPath, buf)) return r;
+    bool io = true;
+    ParseUsersText(std::string_view(buf.data(), buf.size()), [&](std::string_view u, std::string_view c) {
+        if (!io) return;
+        switch (table.Insert(u, c)) {
+            case TableStatus::Ok: r.imported++; break;
+            case TableStatus::Exists: r.duplicates++; break;
+            case TableStatus::TooLong: r.tooLong++; break;
+            default: io = false; break;
+        }
+    });
+    r.ok = io && table.Sync();
+    return r;
+}
+
+// Builds a new table at `tablePath` from users.txt: imports into
+// <tablePath>.tmp, closes (and so syncs) it, then renames it into place. A
+// failed import leaves no table behind, so the next start tries again.
+inline ImportResult CreateTableFromText(const std::string& textPath, const std::string& tablePath) {
+    std::string tmp = tablePath + ".tmp";
+    std::remove(tmp.c_str());
+    ImportResult r;
+    {
+        CredentialTable table;
+        if (!table.Open(tmp)) return r;
+        r = ImportUsersText(textPath, table);
+    }
+    if (r.ok && std::rename(tmp.c_str(), tablePath.c_str()) != 0) r.ok = false;
+    if (!r.ok) std::remove(tmp.c_str());
+    return r;
+}
@@ -0,0 +1,285 @@
+// Password hashing: scrypt (RFC 7914) built from SHA-256, HMAC-SHA256,
+// PBKDF2 and Salsa20/8, with no external library. Stored credentials are
+// self-describing strings, "$scrypt$ln=14,r=8,p=1$<salt hex>$<hash hex>", so
+// the cost can be raised later without breaking existing users. No raylib
+// dependency.
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// ------------------- SHA-256 -------------------
+class Sha256 {
+public:
+    static constexpr size_t DIGEST = 32, BLOCK = 64;
+
+    Sha256() { Reset(); }
+
+    void Reset() {
+        static const uint32_t init[8]={0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19};
+        std::memcpy(h,init,sizeof h);
+        length=0; used=0;
+    }
+
+    void Update(const void *data, size_t n) {
+        if (n==0) return;
+        const uint8_t *p=(const uint8_t*)data;
+        length+=n;
+        if (used) {
+            size_t take=std::min(n,BLOCK-used);
+            std::memcpy(buf+used,p,take);
+            used+=take; p+=take; n-=take;
+            if (used<BLOCK) return;
+            Compress(buf);
+            used=0;
+        }
+        for (;n>=BLOCK;p+=BLOCK,n-=BLOCK) Compress(p);
+        std::memcpy(buf,p,n);
+        used=n;
+    }
+
+    void Final(uint8_t out[DIGEST]) {
+        uint64_t bits=length*8;
+        uint8_t pad=0x80, zero=0, len[8];
+        Update(&pad,1);
+        while (used!=56) Update(&zero,1);
+        for (int i=0;i<8;i++) len[i]=(uint8_t)(bits>>(56-8*i));
+        Update(len,8);
+        for (int i=0;i<8;i++) for (int k=0;k<4;k++) out[4*i+k]=(uint8_t)(h[i]>>(24-8*k));
+    }
+
+private:
+    static uint32_t Rotr(uint32_t x, int n) { return (x>>n)|(x<<(32-n)); }
+
+    void Compress(const uint8_t *p) {
+        static const uint32_t k[64]={
+            0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+            0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+            0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+            0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+            0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+            0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+            0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+            0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2};
+        uint32_t w[64];
+        for (int i=0;i<16;i++) w[i]=(uint32_t)p[4*i]<<24|(uint32_t)p[4*i+1]<<16|(uint32_t)p[4*i+2]<<8|p[4*i+3];
+        for (int i=16;i<64;i++) {
+            uint32_t s0=Rotr(w[i-15],7)^Rotr(w[i-15],18)^(w[i-15]>>3);
+            uint32_t s1=Rotr(w[i-2],17)^Rotr(w[i-2],19)^(w[i-2]>>10);
+            w[i]=w[i-16]+s0+w[i-7]+s1;
+        }
+        uint32_t a=h[0],b=h[1],c=h[2],d=h[3],e=h[4],f=h[5],g=h[6],hh=h[7];
+        for (int i=0;i<64;i++) {
+            uint32_t t1=hh+(Rotr(e,6)^Rotr(e,11)^Rotr(e,25))+((e&f)^(~e&g))+k[i]+w[i];
+            uint32_t t2=(Rotr(a,2)^Rotr(a,13)^Rotr(a,22))+((a&b)^(a&c)^(b&c));
+            hh=g; g=f; f=e; e=d+t1; d=c; c=b; b=a; a=t1+t2;
+        }
+        h[0]+=a; h[1]+=b; h[2]+=c; h[3]+=d; h[4]+=e; h[5]+=f; h[6]+=g; h[7]+=hh;
+    }
+
+    uint32_t h[8];
+    uint64_t length;
+    uint8_t buf[BLOCK];
+    size_t used;
+};
+
+// ------------------- HMAC / PBKDF2 -------------------
+// HMAC-SHA256 with the padded key hashed once, so each message costs only
+// the message blocks and two finalisations.
+class HmacSha256 {
+public:
+    HmacSha256(const void *key, size_t n) {
+        uint8_t k[Sha256::BLOCK]={0}, pad[Sha256::BLOCK];
+        if (n>Sha256::BLOCK) { Sha256 s; s.Update(key,n); s.Final(k); }
+        else std::memcpy(k,key,n);
+        for (size_t i=0;i<Sha256::BLOCK;i++) pad[i]=k[i]^0x36;
+        inner.Update(pad,sizeof pad);
+        for (size_t i=0;i<Sha256::BLOCK;i++) pad[i]=k[i]^0x5c;
+        outer.Update(pad,sizeof pad);
+    }
+
+    // HMAC of the concatenation a || b.
+    void Mac(const void *a, size_t an, const void *b, size_t bn, uint8_t out[Sha256::DIGEST]) const {
+        Sha256 in=inner, out2=outer;
+        in.Update(a,an); in.Update(b,bn);
+        uint8_t d[Sha256::DIGEST];
+        in.Final(d);
+        out2.Update(d,sizeof d);
+        out2.Final(out);
+    }
+
+private:
+    Sha256 inner, outer;
+};
+
+inline void Pbkdf2Sha256(const void *password, size_t pn, const void *salt, size_t sn, uint32_t iterations, uint8_t *out, size_t n) {
+    HmacSha256 mac(password,pn);
+    for (uint32_t block=1;n>0;block++) {
+        uint8_t be[4]={(uint8_t)(block>>24),(uint8_t)(block>>16),(uint8_t)(block>>8),(uint8_t)block};
+        uint8_t u[Sha256::DIGEST], t[Sha256::DIGEST];
+        mac.Mac(salt,sn,be,4,u);
+        std::memcpy(t,u,sizeof t);
+        for (uint32_t i=1;i<iterations;i++) {
+            mac.Mac(u,sizeof u,nullptr,0,u);
+            for (size_t k=0;k<sizeof t;k++) t[k]^=u[k];
+        }
+        size_t take=std::min(n,sizeof t);
+        std::memcpy(out,t,take);
+        out+=take; n-=take;
+    }
+}
+
+// ------------------- scrypt -------------------
+struct KdfParams {
+    int logN=14;                // N = 2^logN; memory is 128 * r * N bytes
+    int r=8;
+    int p=1;
+
+    // Bounds checked for parameters read from a credential file, so a
+    // corrupt line can't demand gigabytes: at most 256 MB of scratch.
+    bool Valid() const { return logN>=1 && logN<=24 && r>=1 && r<=32 && p>=1 && p<=16 && (128ull*r<<logN)<=(256ull<<20); }
+    size_t MemoryBytes() const { return (size_t)128*r<<logN; }
+};
+
+namespace scrypt_detail {
+inline uint32_t Rotl(uint32_t x, int n) { return (x<<n)|(x>>(32-n)); }
+
+inline void Salsa20_8(uint32_t b[16]) {
+    uint32_t x[16];
+    std::memcpy(x,b,sizeof x);
+    for (int i=0;i<8;i+=2) {
+        x[ 4]^=Rotl(x[ 0]+x[12], 7); x[ 8]^=Rotl(x[ 4]+x[ 0], 9); x[12]^=Rotl(x[ 8]+x[ 4],13); x[ 0]^=Rotl(x[12]+x[ 8],18);
+        x[ 9]^=Rotl(x[ 5]+x[ 1], 7); x[13]^=Rotl(x[ 9]+x[ 5], 9); x[ 1]^=Rotl(x[13]+x[ 9],13); x[ 5]^=Rotl(x[ 1]+x[13],18);
+        x[14]^=Rotl(x[10]+x[ 6], 7); x[ 2]^=Rotl(x[14]+x[10], 9); x[ 6]^=Rotl(x[ 2]+x[14],13); x[10]^=Rotl(x[ 6]+x[ 2],18);
+        x[ 3]^=Rotl(x[15]+x[11], 7); x[ 7]^=Rotl(x[ 3]+x[15], 9); x[11]^=Rotl(x[ 7]+x[ 3],13); x[15]^=Rotl(x[11]+x[ 7],18);
+        x[ 1]^=Rotl(x[ 0]+x[ 3], 7); x[ 2]^=Rotl(x[ 1]+x[ 0], 9); x[ 3]^=Rotl(x[ 2]+x[ 1],13); x[ 0]^=Rotl(x[ 3]+x[ 2],18);
+        x[ 6]^=Rotl(x[ 5]+x[ 4], 7); x[ 7]^=Rotl(x[ 6]+x[ 5], 9); x[ 4]^=Rotl(x[ 7]+x[ 6],13); x[ 5]^=Rotl(x[ 4]+x[ 7],18);
+        x[11]^=Rotl(x[10]+x[ 9], 7); x[ 8]^=Rotl(x[11]+x[10], 9); x[ 9]^=Rotl(x[ 8]+x[11],13); x[10]^=Rotl(x[ 9]+x[ 8],18);
+        x[12]^=Rotl(x[15]+x[14], 7); x[13]^=Rotl(x[12]+x[15], 9); x[14]^=Rotl(x[13]+x[12],13); x[15]^=Rotl(x[14]+x[13],18);
+    }
+    for (int i=0;i<16;i++) b[i]+=x[i];
+}
+
+// in: 2r 64-byte blocks as words; out: the mixed blocks, evens then odds.
+inline void BlockMix(const uint32_t *in, uint32_t *out, int r) {
+    uint32_t x[16];
+    std::memcpy(x,in+(2*r-1)*16,sizeof x);
+    for (int i=0;i<2*r;i++) {
+        for (int k=0;k<16;k++) x[k]^=in[i*16+k];
+        Salsa20_8(x);
+        std::memcpy(out+((i&1)*r+i/2)*16,x,sizeof x);
+    }
+}
+
+// Mixes one 128r-byte lane in place using v (N lanes of scratch).
+inline void RoMix(uint8_t *lane, int r, uint32_t n, uint32_t *v) {
+    const size_t words=32*(size_t)r;
+    std::vector<uint32_t> x(words), y(words);
+    for (size_t i=0;i<words;i++) x[i]=(uint32_t)lane[4*i]|(uint32_t)lane[4*i+1]<<8|(uint32_t)lane[4*i+2]<<16|(uint32_t)lane[4*i+3]<<24;
+    for (uint32_t i=0;i<n;i++) {
+        std::memcpy(v+i*words,x.data(),words*4);
+        BlockMix(x.data(),y.data(),r);
+        x.swap(y);
+    }
+    for (uint32_t i=0;i<n;i++) {
+        uint32_t j=x[words-16]&(n-1);   // Integerify: first word of the last block
+        const uint32_t *vj=v+j*words;
+        for (size_t k=0;k<words;k++) x[k]^=vj[k];
+        BlockMix(x.data(),y.data(),r);
+        x.swap(y);
+    }
+    for (size_t i=0;i<words;i++) for (int k=0;k<4;k++) lane[4*i+k]=(uint8_t)(x[i]>>(8*k));
+}
+}
+
+// Derives `n` bytes into `out`; false if the parameters are out of bounds
+// or the scratch memory can't be allocated.
+inline bool Scrypt(const void *password, size_t pn, const void *salt, size_t sn, const KdfParams &kp, uint8_t *out, size_t n) {
+    if (!kp.Valid()) return false;
+    const size_t laneBytes=128*(size_t)kp.r;
+    std::vector<uint8_t> b(laneBytes*kp.p);
+    std::vector<uint32_t> v;
+    try { v.resize(kp.MemoryBytes()/4); } catch (const std::bad_alloc&) { return false; }
+    Pbkdf2Sha256(password,pn,salt,sn,1,b.data(),b.size());
+    for (int i=0;i<kp.p;i++) scrypt_detail::RoMix(b.data()+i*laneBytes,kp.r,1u<<kp.logN,v.data());
+    Pbkdf2Sha256(password,pn,b.data(),b.size(),1,out,n);
+    return true;
+}
+
+// ------------------- Credentials -------------------
+constexpr size_t SALT_BYTES = 16, HASH_BYTES = 32;
+
+inline std::string ToHex(const uint8_t *p, size_t n) {
+    static const char digits[]="0123456789abcdef";
+    std::string s(2*n,'0');
+    for (size_t i=0;i<n;i++) { s[2*i]=digits[p[i]>>4]; s[2*i+1]=digits[p[i]&15]; }
+    return s;
+}
+
+inline bool FromHex(const std::string &s, uint8_t *p, size_t n) {
+    if (s.size()!=2*n) return false;
+    auto nibble=[](char c)->int { return c>='0'&&c<='9' ? c-'0' : c>='a'&&c<='f' ? c-'a'+10 : -1; };
+    for (size_t i=0;i<n;i++) {
+        int hi=nibble(s[2*i]), lo=nibble(s[2*i+1]);
+        if (hi<0||lo<0) return false;
+        p[i]=(uint8_t)(hi<<4|lo);
+    }
+    return true;
+}
+
+struct ParsedCredential {
+    KdfParams params;
+    uint8_t salt[SALT_BYTES], hash[HASH_BYTES];
+};
+
+inline bool IsHashedCredential(const std::string &s) { return s.compare(0,8,"$scrypt$")==0; }
+
+inline bool ParseCredential(const std::string &s, ParsedCredential &out) {
+    char salt[2*SALT_BYTES+1], hash[2*HASH_BYTES+1];
+    int used=0;
+    if (std::sscanf(s.c_str(),"$scrypt$ln=%d,r=%d,p=%d$%32[0-9a-f]$%64[0-9a-f]%n",&out.params.logN,&out.params.r,&out.params.p,salt,hash,&used)!=5) return false;
+    return (size_t)used==s.size() && out.params.Valid() && FromHex(salt,out.salt,SALT_BYTES) && FromHex(hash,out.hash,HASH_BYTES);
+}
+
+// Salted with 16 bytes from the OS's random source. Empty if the
+// parameters are invalid.
+inline std::string HashPassword(const std::string &password, const KdfParams &kp=KdfParams()) {
+    uint8_t salt[SALT_BYTES], hash[HASH_BYTES];
+    std::random_device rd;
+    for (size_t i=0;i<SALT_BYTES;i+=4) { uint32_t w=rd(); std::memcpy(salt+i,&w,4); }
+    if (!Scrypt(password.data(),password.size(),salt,sizeof salt,kp,hash,sizeof hash)) return "";
+    char head[48];
+    std::snprintf(head,sizeof head,"$scrypt$ln=%d,r=%d,p=%d$",kp.logN,kp.r,kp.p);
+    return head+ToHex(salt,sizeof salt)+"$"+ToHex(hash,sizeof hash);
+}
+
+// Compares every byte, so the time taken doesn't depend on where they differ.
+inline bool ConstantTimeEqual(const void *a, const void *b, size_t n) {
+    const uint8_t *x=(const uint8_t*)a, *y=(const uint8_t*)b;
+    uint8_t diff=0;
+    for (size_t i=0;i<n;i++) diff|=x[i]^y[i];
+    return diff==0;
+}
+
+// True when `credential` is plain text or was hashed with other parameters,
+// so a successful login should store a fresh hash.
+inline bool NeedsRehash(const std::string &credential, const KdfParams &kp) {
+    ParsedCredential c;
+    if (!IsHashedCredential(credential) || !ParseCredential(credential,c)) return true;
+    return c.params.logN!=kp.logN || c.params.r!=kp.r || c.params.p!=kp.p;
+}
+
+// Lines written before passwords were hashed hold the password itself; they
+// are still accepted.
+inline bool VerifyPassword(const std::string &password, const std::string &credential) {
+    ParsedCredential c;
+    if (!IsHashedCredential(credential) || !ParseCredential(credential,c))
+        return password.size()==credential.size() && ConstantTimeEqual(password.data(),credential.data(),password.size());
+    uint8_t hash[HASH_BYTES];
+    return Scrypt(password.data(),password.size(),c.salt,SALT_BYTES,c.params,hash,sizeof hash) && ConstantTimeEqual(hash,c.hash,sizeof hash);
+}
@@ -0,0 +1,114 @@
+// In-memory credential index: usernames hashed into an open-addressing table
+// whose entries point into one packed string arena, so a million users cost
+// three allocations and a lookup touches one slot and one arena record on
+// average. No raylib dependency.
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ------------------- Hashing -------------------
+// 64-bit FNV-1a: stable across runs and platforms, cheap for short names.
+inline uint64_t HashName(std::string_view s) {
+    uint64_t h=0xcbf29ce484222325ull;
+    for (unsigned char ch: s) { h^=ch; h*=0x100000001b3ull; }
+    return h;
+}
+
+// ------------------- Credential Index -------------------
+// Linear probing over 8-byte slots {32 hash bits, record+1}; 0 = empty.
+// Users are never removed, so there are no tombstones. The stored hash bits
+// reject almost every non-matching slot without touching the arena. Not
+// thread-safe.
+class CredentialIndex {
+public:
+    static constexpr int MIN_BITS = 10;
+
+    CredentialIndex() { Clear(); }
+
+    // Sets `password` to the one stored for `name`; the view stays valid
+    // until the next Insert().
+    bool Find(std::string_view name, std::string_view &password) const {
+        uint64_t h=HashName(name);
+        for (size_t i=Home(h);;i=(i+1)&mask) {
+            const Slot &s=slots[i];
+            if (s.rec==0) return false;
+            if (s.tag==Tag(h) && Name(s.rec-1)==name) { password=Password(s.rec-1); return true; }
+        }
+    }
+
+    // False if `name` is already present.
+    bool Insert(std::string_view name, std::string_view password) {
+        uint64_t h=HashName(name);
+        if ((recs.size()+1)*4>(mask+1)*3) Grow(bits+1);   // keep load under 3/4
+        size_t i=Home(h);
+        for (;slots[i].rec!=0;i=(i+1)&mask)
+            if (slots[i].tag==Tag(h) && Name(slots[i].rec-1)==name) return false;
+        recs.push_back(Rec{(uint32_t)arena.size(),(uint32_t)name.size(),(uint32_t)password.size()});
+        arena.append(name).append(password);
+        slots[i]=Slot{Tag(h),(uint32_t)recs.size()};
+        return true;
+    }
+
+    // Sizes the table and arena for `users` more users averaging `bytes`
+    // of name and password each, so a bulk load never rehashes.
+    void Reserve(size_t users, size_t bytes=16) {
+        size_t want=recs.size()+users;
+        int b=bits;
+        while (want*4>(size_t(1)<<b)*3) b++;
+        if (b>bits) Grow(b);
+        recs.reserve(want);
+        arena.reserve(arena.size()+users*bytes);
+    }
+
+    size_t Size() const { return recs.size(); }
+
+    // Table and arena bytes, for the benchmark.
+    size_t MemoryBytes() const { return slots.capacity()*sizeof(Slot)+recs.capacity()*sizeof(Rec)+arena.capacity(); }
+
+    void Clear() {
+        bits=MIN_BITS;
+        mask=(size_t(1)<<bits)-1;
+        slots.assign(mask+1,Slot{0,0});
+        recs.clear();
+        arena.clear();
+    }
+
+private:
+    struct Slot {
+        uint32_t tag;           // high hash bits
+        uint32_t rec;           // record index + 1
+    };
+    struct Rec {
+        uint32_t offset, nameLen, passLen;
+    };
+
+    static uint32_t Tag(uint64_t h) { return (uint32_t)(h>>32); }
+    size_t Home(uint64_t h) const { return (size_t)(h*0x9E3779B97F4A7C15ull>>(64-bits)); }
+
+    std::string_view Name(uint32_t r) const { return std::string_view(arena.data()+recs[r].offset,recs[r].nameLen); }
+    std::string_view Password(uint32_t r) const {
+        return std::string_view(arena.data()+recs[r].offset+recs[r].nameLen,recs[r].passLen);
+    }
+
+    // Rehashes from the records; the stored tags can't be reused because the
+    // home slot depends on the full hash.
+    void Grow(int newBits) {
+        bits=newBits;
+        mask=(size_t(1)<<bits)-1;
+        slots.assign(mask+1,Slot{0,0});
+        for (uint32_t r=0;r<recs.size();r++) {
+            uint64_t h=HashName(Name(r));
+            size_t i=Home(h);
+            while (slots[i].rec!=0) i=(i+1)&mask;
+            slots[i]=Slot{Tag(h),r+1};
+        }
+    }
+
+    int bits=MIN_BITS;
+    size_t mask=0;
+    std::vector<Slot> slots;
+    std::vector<Rec> recs;
+    std::string arena;          // name then password, per record (under 4 GB)
+};
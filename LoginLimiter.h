@@ -0,0 +1,341 @@
+// Login attempt limiting: failures are counted per key (a username, or the
+// source an attempt came from) in sliding windows. Consecutive failures earn
+// an exponential backoff, and too many in one window lock the key out for a
+// while. Keys live in a fixed number of slots per shard; when a shard is full
+// the least recently seen key is forgotten, so memory stays bounded however
+// many names an attacker sprays. No raylib dependency.
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "LoginIndex.h"
+
+// ------------------- Policy -------------------
+struct LimitPolicy {
+    int freeFailures=3;             // consecutive failures before any backoff
+    int64_t baseDelayMs=1000;       // first backoff; doubles with each further failure
+    int64_t maxDelayMs=60*1000;
+    int64_t windowMs=15*60*1000;    // sliding window the lockout counts over
+    int lockoutFailures=10;         // failures within a window that lock the key
+    int64_t lockoutMs=15*60*1000;   // first lockout; doubles on each repeat, up to 16x
+};
+
+enum class LimitReason { None, Backoff, Lockout };
+
+struct LimitDecision {
+    bool allowed=true;
+    LimitReason reason=LimitReason::None;
+    int64_t retryAfterMs=0;
+};
+
+struct LimiterStats {
+    uint64_t checks=0, denied=0, records=0;
+    uint64_t evictions=0;
+    uint64_t evictedBlocked=0;      // keys forgotten while still backed off or locked
+    size_t entries=0, capacity=0;
+    size_t memoryBytes=0;           // slots plus an estimate of the index
+};
+
+// Milliseconds on the steady clock, the time base Check() and Record() expect.
+inline int64_t LimiterNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ------------------- Attempt Tracker -------------------
+// 2^shardBits shards, each a mutex over its own slots, index and LRU list, so
+// checks on different keys rarely contend. The window count is the usual
+// two-bucket estimate: this window's failures plus the previous window's,
+// weighted by how much of it still overlaps. Thread-safe.
+class AttemptTracker {
+public:
+    explicit AttemptTracker(const LimitPolicy &policy=LimitPolicy(), size_t capacity=1<<16, int shardBits=4)
+        : policy(policy), shardBits(shardBits), shards(new Shard[size_t(1)<<shardBits]) {
+        size_t perShard=std::max<size_t>(1,capacity>>shardBits);
+        for (size_t i=0;i<ShardCount();i++) {
+            shards[i].slots.resize(perShard);
+            shards[i].index.reserve(perShard);
+        }
+    }
+
+    AttemptTracker(const AttemptTracker&)=delete;
+    AttemptTracker &operator=(const AttemptTracker&)=delete;
+
+    // Whether `key` may try now. Unknown keys always may and aren't stored.
+    LimitDecision Check(std::string_view key, int64_t nowMs) {
+        uint64_t h=HashName(key);
+        Shard &s=ShardOf(h);
+        std::lock_guard<std::mutex> lk(s.m);
+        s.checks++;
+        LimitDecision d;
+        auto it=s.index.find(h);
+        if (it==s.index.end()) return d;
+        Entry &e=s.slots[it->second];
+        Touch(s,it->second);
+        if (nowMs<e.blockedUntil) {
+            s.denied++;
+            d.allowed=false;
+            d.reason=e.locked ? LimitReason::Lockout : LimitReason::Backoff;
+            d.retryAfterMs=e.blockedUntil-nowMs;
+        }
+        return d;
+    }
+
+    // Check() for an attempt that is about to be hashed. Allowed attempts
+    // count as in flight until Release(), and in flight they count against
+    // the lockout as if they had failed, so a burst of parallel guesses
+    // can't all pass while the first is still hashing. A key whose backoff
+    // has run out gets one attempt in flight at a time. Stores new keys.
+    LimitDecision Admit(std::string_view key, int64_t nowMs) {
+        uint64_t h=HashName(key);
+        Shard &s=ShardOf(h);
+        std::lock_guard<std::mutex> lk(s.m);
+        s.checks++;
+        LimitDecision d;
+        auto it=s.index.find(h);
+        uint32_t i=it==s.index.end() ? Insert(s,h,nowMs) : it->second;
+        Entry &e=s.slots[i];
+        Touch(s,i);
+        Roll(e,nowMs);
+        if (nowMs<e.blockedUntil) {
+            d.allowed=false;
+            d.reason=e.locked ? LimitReason::Lockout : LimitReason::Backoff;
+            d.retryAfterMs=e.blockedUntil-nowMs;
+        } else if (e.inflight && (e.inflight==UINT16_MAX || e.consecutive>policy.freeFailures
+                                  || WindowCount(e,nowMs)+e.inflight>=policy.lockoutFailures)) {
+            d.allowed=false;                        // wait for the ones in flight to settle
+            d.reason=LimitReason::Backoff;
+            d.retryAfterMs=policy.baseDelayMs;
+        }
+        if (d.allowed) e.inflight++;
+        else s.denied++;
+        return d;
+    }
+
+    // Ends an attempt Admit() allowed; Record() its outcome, if it has one.
+    void Release(std::string_view key) {
+        uint64_t h=HashName(key);
+        Shard &s=ShardOf(h);
+        std::lock_guard<std::mutex> lk(s.m);
+        auto it=s.index.find(h);
+        if (it!=s.index.end() && s.slots[it->second].inflight) s.slots[it->second].inflight--;
+    }
+
+    // Counts the outcome of an attempt Check() allowed. A success clears the
+    // backoff and the lockout history but not the window, so an attacker who
+    // owns one account can't launder failures by logging into it.
+    void Record(std::string_view key, bool success, int64_t nowMs) {
+        uint64_t h=HashName(key);
+        Shard &s=ShardOf(h);
+        std::lock_guard<std::mutex> lk(s.m);
+        s.records++;
+        auto it=s.index.find(h);
+        if (it==s.index.end() && success) return;  // nothing worth remembering
+        uint32_t i=it==s.index.end() ? Insert(s,h,nowMs) : it->second;
+        Entry &e=s.slots[i];
+        Touch(s,i);
+        Roll(e,nowMs);
+        if (success) { e.consecutive=0; e.lockouts=0; return; }
+        if (e.current<UINT16_MAX) e.current++;
+        if (e.consecutive<UINT16_MAX) e.consecutive++;
+        if (e.consecutive>policy.freeFailures) {
+            int doublings=std::min(e.consecutive-policy.freeFailures-1,30);
+            int64_t delay=std::min(policy.maxDelayMs,policy.baseDelayMs<<doublings);
+            if (nowMs+delay>e.blockedUntil) { e.blockedUntil=nowMs+delay; e.locked=false; }
+        }
+        if (WindowCount(e,nowMs)>=policy.lockoutFailures) {
+            int64_t lock=policy.lockoutMs<<std::min<int>(e.lockouts,4);
+            if (nowMs+lock>e.blockedUntil) { e.blockedUntil=nowMs+lock; e.locked=true; }
+            if (e.lockouts<UINT8_MAX) e.lockouts++;
+            e.current=e.previous=0;                 // the next lockout needs a fresh window's worth
+        }
+    }
+
+    LimiterStats Stats() {
+        LimiterStats st;
+        for (size_t i=0;i<ShardCount();i++) {
+            Shard &s=shards[i];
+            std::lock_guard<std::mutex> lk(s.m);
+            st.checks+=s.checks; st.denied+=s.denied; st.records+=s.records;
+            st.evictions+=s.evictions; st.evictedBlocked+=s.evictedBlocked;
+            st.entries+=s.index.size();
+            st.capacity+=s.slots.size();
+            // unordered_map: a bucket pointer per bucket, a node per key
+            st.memoryBytes+=sizeof(Shard)+s.slots.capacity()*sizeof(Entry)+s.index.bucket_count()*sizeof(void*)
+                           +s.index.size()*(sizeof(void*)+sizeof(uint64_t)+sizeof(uint32_t)+sizeof(size_t));
+        }
+        return st;
+    }
+
+    const LimitPolicy &Policy() const { return policy; }
+
+private:
+    static constexpr uint32_t NIL=UINT32_MAX;
+
+    struct Entry {
+        uint64_t key;
+        int64_t windowStart;        // start of the window `current` counts
+        int64_t blockedUntil;
+        uint32_t prev, next;        // LRU links; head is the most recent
+        uint16_t current, previous; // failures in this window and the one before
+        uint16_t consecutive;
+        uint16_t inflight;          // admitted attempts not yet released
+        uint8_t lockouts;
+        bool locked;                // blockedUntil comes from a lockout, not a backoff
+    };
+
+    struct alignas(64) Shard {
+        std::mutex m;
+        std::vector<Entry> slots;
+        std::unordered_map<uint64_t,uint32_t> index;
+        uint32_t head=NIL, tail=NIL;
+        uint32_t used=0;            // slots handed out so far
+        uint64_t checks=0, denied=0, records=0, evictions=0, evictedBlocked=0;
+    };
+
+    size_t ShardCount() const { return size_t(1)<<shardBits; }
+    Shard &ShardOf(uint64_t h) { return shards[shardBits ? h>>(64-shardBits) : 0]; }
+
+    static void Unlink(Shard &s, uint32_t i) {
+        Entry &e=s.slots[i];
+        if (e.prev!=NIL) s.slots[e.prev].next=e.next; else s.head=e.next;
+        if (e.next!=NIL) s.slots[e.next].prev=e.prev; else s.tail=e.prev;
+    }
+
+    static void PushFront(Shard &s, uint32_t i) {
+        Entry &e=s.slots[i];
+        e.prev=NIL; e.next=s.head;
+        if (s.head!=NIL) s.slots[s.head].prev=i; else s.tail=i;
+        s.head=i;
+    }
+
+    static void Touch(Shard &s, uint32_t i) {
+        if (s.head==i) return;
+        Unlink(s,i);
+        PushFront(s,i);
+    }
+
+    // A free slot, or the least recently seen key's, linked at the head of
+    // the LRU list; the caller fills in everything but the links.
+    static uint32_t Acquire(Shard &s, int64_t nowMs) {
+        uint32_t i;
+        if (s.used<s.slots.size()) {
+            i=s.used++;
+        } else {
+            i=s.tail;
+            s.evictions++;
+            if (nowMs<s.slots[i].blockedUntil) s.evictedBlocked++;
+            s.index.erase(s.slots[i].key);
+            Unlink(s,i);
+        }
+        PushFront(s,i);
+        return i;
+    }
+
+    // A fresh entry for key `h`, indexed.
+    static uint32_t Insert(Shard &s, uint64_t h, int64_t nowMs) {
+        uint32_t i=Acquire(s,nowMs);
+        Entry &e=s.slots[i];
+        e.key=h; e.windowStart=e.blockedUntil=0;
+        e.current=e.previous=e.consecutive=e.inflight=0; e.lockouts=0; e.locked=false;
+        s.index.emplace(h,i);
+        return i;
+    }
+
+    // Moves the window forward to the one holding `nowMs`. Windows are
+    // aligned to multiples of windowMs; a late timestamp from another
+    // thread counts in the current window.
+    void Roll(Entry &e, int64_t nowMs) const {
+        int64_t start=nowMs-nowMs%policy.windowMs;
+        if (start<=e.windowStart) return;
+        e.previous=start==e.windowStart+policy.windowMs ? e.current : 0;
+        e.current=0;
+        e.windowStart=start;
+    }
+
+    double WindowCount(const Entry &e, int64_t nowMs) const {
+        double into=double(std::max<int64_t>(0,nowMs-e.windowStart))/policy.windowMs;
+        return e.current+e.previous*std::max(0.0,1.0-into);
+    }
+
+    LimitPolicy policy;
+    int shardBits;
+    std::unique_ptr<Shard[]> shards;
+};
+
+// ------------------- Login Limiter -------------------
+// One tracker per username and one per source (an address, or "local" for
+// the window). A source gets a looser policy since many users can share it.
+// Admit() before any table lookup or hash; Settle() once the answer is known.
+// Registrations cost a hash whatever their outcome, so a third tracker
+// counts every one a source starts: a plain rate limit, no backoff.
+struct LoginLimiter {
+    static LimitPolicy SourcePolicy() {
+        LimitPolicy p;
+        p.freeFailures=20;
+        p.lockoutFailures=100;
+        return p;
+    }
+
+    // 100 registrations per source per 15 minutes, then a minute's pause
+    // that doubles on each repeat.
+    static LimitPolicy RegistrationPolicy() {
+        LimitPolicy p;
+        p.freeFailures=INT_MAX;
+        p.lockoutFailures=100;
+        p.lockoutMs=60*1000;
+        return p;
+    }
+
+    explicit LoginLimiter(size_t capacity=1<<16, const LimitPolicy &userPolicy=LimitPolicy(), const LimitPolicy &sourcePolicy=SourcePolicy(),
+                          const LimitPolicy &registrationPolicy=RegistrationPolicy())
+        : users(userPolicy,capacity), sources(sourcePolicy,capacity), registrations(registrationPolicy,capacity) {}
+
+    // The stricter of the two answers.
+    LimitDecision Check(std::string_view username, std::string_view source, int64_t nowMs) {
+        LimitDecision a=sources.Check(source,nowMs);
+        LimitDecision b=users.Check(username,nowMs);
+        return a.retryAfterMs>=b.retryAfterMs ? a : b;
+    }
+
+    void Record(std::string_view username, std::string_view source, bool success, int64_t nowMs) {
+        users.Record(username,success,nowMs);
+        sources.Record(source,success,nowMs);
+    }
+
+    // Check() that also holds the attempt's place against the username
+    // until it is settled or released. A source only counts finished
+    // attempts: many users can share one, and their logins in flight
+    // shouldn't hold each other back.
+    LimitDecision Admit(std::string_view username, std::string_view source, int64_t nowMs) {
+        LimitDecision a=sources.Check(source,nowMs);
+        LimitDecision b=a.allowed ? users.Admit(username,nowMs) : users.Check(username,nowMs);
+        return a.retryAfterMs>=b.retryAfterMs ? a : b;
+    }
+
+    // Counts the outcome of an attempt Admit() allowed.
+    void Settle(std::string_view username, std::string_view source, bool success, int64_t nowMs) {
+        users.Release(username);
+        Record(username,source,success,nowMs);
+    }
+
+    // Withdraws an attempt Admit() allowed that was never hashed.
+    void Release(std::string_view username) { users.Release(username); }
+
+    // A source that is backing off from failed logins can't register either.
+    LimitDecision CheckRegistration(std::string_view source, int64_t nowMs) {
+        LimitDecision a=sources.Check(source,nowMs);
+        LimitDecision b=registrations.Check(source,nowMs);
+        return a.retryAfterMs>=b.retryAfterMs ? a : b;
+    }
+
+    // Counts a registration that is about to be hashed.
+    void RecordRegistration(std::string_view source, int64_t nowMs) { registrations.Record(source,false,nowMs); }
+
+    AttemptTracker users, sources, registrations;
+};
@@ -0,0 +1,72 @@
+// Headless authentication service: serves users.db (LoginService.h) over a
+// Unix domain socket, or a localhost TCP port, until SIGINT or SIGTERM.
+// The login GUI and `login_tool load` are its clients. Needs Linux (epoll).
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "LoginService.h"
+
+static void PrintUsage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s [--socket path] [--port n] [--db path] [--import path] [-j threads]\n"
+        "          [--queue n] [--logn n] [--r n] [--p n]\n"
+        "  Listens on <path> (default login.sock), or 127.0.0.1:<n> with --port.\n"
+        "  Serves <db> (default users.db), importing <import> (default users.txt)\n"
+        "  when it doesn't exist yet. -j hashes run at once (default 2), --queue\n"
+        "  more wait in the pool; --logn/--r/--p set the cost of new hashes.\n",
+        argv0);
+}
+
+#ifdef __linux__
+static AuthServer* running = nullptr;
+
+static void OnSignal(int) {
+    if (running) running->Stop();
+}
+
+int main(int argc, char** argv) {
+    AuthConfig config;
+    ServiceAddress addr;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!v) { PrintUsage(argv[0]); return 2; }
+        if (a == "--socket") addr.socketPath = v;
+        else if (a == "--port") addr.port = std::atoi(v);
+        else if (a == "--db") config.dbPath = v;
+        else if (a == "--import") config.importPath = v;
+        else if (a == "-j") config.threads = (unsigned)std::atoi(v);
+        else if (a == "--queue") config.maxPending = (size_t)std::atol(v);
+        else if (a == "--logn") config.params.logN = std::atoi(v);
+        else if (a == "--r") config.params.r = std::atoi(v);
+        else if (a == "--p") config.params.p = std::atoi(v);
+        else { PrintUsage(argv[0]); return 2; }
+        ++i;
+    }
+    if (!config.params.Valid()) { std::fprintf(stderr, "cost out of range (at most 256 MB: 128 * r * 2^logN)\n"); return 2; }
+
+    AuthCore core(config);
+    std::string message = core.Open();
+    if (!core.IsOpen()) { std::fprintf(stderr, "%s\n", message.c_str()); return 1; }
+    if (!message.empty()) std::printf("%s\n", message.c_str());
+    AuthServer server(core);
+    if (!server.Listen(addr)) { std::fprintf(stderr, "cannot listen on %s\n", addr.ToString().c_str()); return 1; }
+    running = &server;
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+    std::printf("Serving %zu users from %s on %s\n", core.Users(), config.dbPath.c_str(), addr.ToString().c_str());
+    std::fflush(stdout);
+    server.Run();
+    running = nullptr;
+    std::printf("Stopped\n");
+    return 0;
+}
+#else
+int main(int, char** argv) {
+    PrintUsage(argv[0]);
+    std::fprintf(stderr, "The service needs Linux (epoll).\n");
+    return 1;
+}
+#endif
@@ -0,0 +1,671 @@
+// Authentication service: the register/login logic as a headless core that
+// owns the credential table (LoginTable.h), the hashing pool
+// (LoginWorkers.h) and the attempt limiter (LoginLimiter.h), plus a line
+// protocol to reach it over a local socket. AuthServer serves the core from
+// an epoll loop (Linux); AuthClient is what the GUI and `login_tool load`
+// speak through. No raylib dependency.
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "LoginCore.h"
+#include "LoginLimiter.h"
+#include "LoginWorkers.h"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <atomic>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+// ---------- Protocol ----------
+// One request per line, fields separated by tabs:
+//     LOGIN <tab> username <tab> password
+//     REGISTER <tab> username <tab> password
+// and one reply line per request, in order:
+//     STATUS <tab> value
+// where value is the hashing time in ms, or for BACKOFF and LOCKED the ms
+// until the next attempt is allowed.
+enum class AuthOp { Login, Register };
+
+enum class AuthStatus { Ok, Invalid, Exists, TooLong, Empty, Backoff, Locked, Busy, Error, Bad };
+
+struct AuthRequest {
+    AuthOp op = AuthOp::Login;
+    std::string username;
+    std::string password;
+};
+
+struct AuthReply {
+    uint64_t tag = 0;           // the request's, as given to Submit()
+    AuthStatus status = AuthStatus::Error;
+    double ms = 0;              // time spent hashing
+    int64_t retryAfterMs = 0;   // Backoff and Locked
+};
+
+inline const char* AuthStatusName(AuthStatus s) {
+    static const char* names[] = {"OK", "INVALID", "EXISTS", "TOOLONG", "EMPTY", "BACKOFF", "LOCKED", "BUSY", "ERROR", "BAD"};
+    return names[(int)s];
+}
+
+constexpr size_t MAX_REQUEST_LINE = 1024;
+
+// False if a field holds a tab or line break, which the format can't carry.
+inline bool FormatRequest(const AuthRequest& req, std::string& line) {
+    for (const std::string* f : {&req.username, &req.password})
+        if (f->find_first_of("\t\r\n") != std::string::npos) return false;
+    line = req.op == AuthOp::Login ? "LOGIN\t" : "REGISTER\t";
+    line += req.username;
+    line += '\t';
+    line += req.password;
+    line += '\n';
+    return line.size() <= MAX_REQUEST_LINE;
+}
+
+// `line` without its line break.
+inline bool ParseRequest(std::string_view line, AuthRequest& req) {
+    size_t a = line.find('\t');
+    size_t b = a == std::string_view::npos ? a : line.find('\t', a + 1);
+    if (b == std::string_view::npos || line.find('\t', b + 1) != std::string_view::npos) return false;
+    std::string_view op = line.substr(0, a);
+    if (op == "LOGIN") req.op = AuthOp::Login;
+    else if (op == "REGISTER") req.op = AuthOp::Register;
+    else return false;
+    req.username.assign(line.substr(a + 1, b - a - 1));
+    req.password.assign(line.substr(b + 1));
+    return true;
+}
+
+inline std::string FormatReply(const AuthReply& r) {
+    char buf[64];
+    bool limited = r.status == AuthStatus::Backoff || r.status == AuthStatus::Locked;
+    if (limited) std::snprintf(buf, sizeof buf, "%s\t%lld\n", AuthStatusName(r.status), (long long)r.retryAfterMs);
+    else std::snprintf(buf, sizeof buf, "%s\t%.1f\n", AuthStatusName(r.status), r.ms);
+    return buf;
+}
+
+inline bool ParseReply(std::string_view line, AuthReply& r) {
+    size_t tab = line.find('\t');
+    if (tab == std::string_view::npos) return false;
+    std::string_view name = line.substr(0, tab);
+    std::string value(line.substr(tab + 1));
+    for (int s = 0; s <= (int)AuthStatus::Bad; ++s) {
+        if (name != AuthStatusName((AuthStatus)s)) continue;
+        r.status = (AuthStatus)s;
+        if (r.status == AuthStatus::Backoff || r.status == AuthStatus::Locked) r.retryAfterMs = std::atoll(value.c_str());
+        else r.ms = std::atof(value.c_str());
+        return true;
+    }
+    return false;
+}
+
+// ---------- Auth Core ----------
+struct AuthConfig {
+    std::string dbPath = "users.db";
+    std::string importPath = "users.txt";   // imported when dbPath doesn't exist yet
+    KdfParams params;                       // cost of new hashes
+    unsigned threads = 2;                   // hashes running at once
+    size_t maxPending = 8;                  // hashes queued in the pool
+    size_t maxWaiting = 1024;               // requests held back while the pool is full; beyond that, BUSY
+    size_t limiterCapacity = 1 << 16;       // keys per limiter tracker
+};
+
+// Single-threaded: Submit() and Poll() come from one thread (the window, or
+// the server's loop). Every request is answered through Poll(), even those
+// decided on the spot, so callers handle one path.
+class AuthCore {
+public:
+    explicit AuthCore(AuthConfig config = AuthConfig())
+        : config(config), workers(config.threads, config.maxPending), limiter(config.limiterCapacity) {}
+    ~AuthCore() { Close(); }
+
+    AuthCore(const AuthCore&) = delete;
+    AuthCore& operator=(const AuthCore&) = delete;
+
+    // Opens the table, importing the text file the first time. Returns a
+    // message for the user, empty when there's nothing to say; requests
+    // answer ERROR if the table couldn't be opened.
+    std::string Open() {
+        FILE* existing = std::fopen(config.dbPath.c_str(), "rb");
+        if (existing) std::fclose(existing);
+        ImportResult r;
+        if (!existing && !(r = CreateTableFromText(config.importPath, config.dbPath)).ok)
+            return "Could not import " + config.importPath + "!";
+        if (!table.Open(config.dbPath)) return "Cannot open " + config.dbPath + "!";
+        open = true;
+        return r.imported ? "Imported " + std::to_string(r.imported) + " users from " + config.importPath : "";
+    }
+
+    // False until Open() succeeds, and again after Close().
+    bool IsOpen() const { return open; }
+
+    // See AuthWorkers::OnResult.
+    void OnResult(std::function<void()> fn) { workers.OnResult(std::move(fn)); }
+
+    // Starts a request. `source` identifies the caller for the limiter;
+    // `tag` comes back on the reply.
+    void Submit(const AuthRequest& req, const std::string& source, uint64_t tag) {
+        AuthReply reply;
+        reply.tag = tag;
+        AuthJob job;
+        job.username = req.username;
+        job.password = req.password;
+        job.params = config.params;
+        if (!open) {
+            reply.status = AuthStatus::Error;
+        } else if (req.op == AuthOp::Register) {
+            std::string existing;
+            LimitDecision limit;
+            if (req.username.empty() || req.password.empty()) reply.status = AuthStatus::Empty;
+            else if (req.username.size() > CredentialTable::MAX_NAME) reply.status = AuthStatus::TooLong;
+            else if (!(limit = limiter.CheckRegistration(source, LimiterNowMs())).allowed) Refuse(limit, reply);
+            else if (table.Find(req.username, existing)) reply.status = AuthStatus::Exists;
+            else {
+                limiter.RecordRegistration(source, LimiterNowMs());
+                job.kind = AuthJobKind::Hash;
+                return Enqueue(Waiting{tag, source, std::move(job)});
+            }
+        } else {
+            // Refused attempts cost no table read and no hash. Admitted ones
+            // count against the limit until they finish, so parallel guesses
+            // can't all get in before the first is answered.
+            LimitDecision limit = limiter.Admit(req.username, source, LimiterNowMs());
+            if (!limit.allowed) {
+                Refuse(limit, reply);
+            } else {
+                job.kind = AuthJobKind::Verify;
+                return Enqueue(Waiting{tag, source, std::move(job)});
+            }
+        }
+        ready.push_back(reply);
+    }
+
+    // Takes a finished reply without blocking.
+    bool Poll(AuthReply& reply) {
+        Collect();
+        SubmitWaiting();
+        if (ready.empty()) return false;
+        reply = ready.front();
+        ready.pop_front();
+        return true;
+    }
+
+    // Requests not yet answered by Poll().
+    size_t InFlight() const { return started.size() + waiting.size() + ready.size(); }
+
+    size_t Users() const { return table.Size(); }
+    LoginLimiter& Limiter() { return limiter; }
+
+    void Close() {
+        workers.Stop();
+        if (open) table.Close();
+        open = false;
+    }
+
+private:
+    struct Waiting {
+        uint64_t tag;
+        std::string source;
+        AuthJob job;
+    };
+
+    struct Started {
+        uint64_t tag;
+        std::string source;
+    };
+
+    static void Refuse(const LimitDecision& limit, AuthReply& reply) {
+        reply.status = limit.reason == LimitReason::Lockout ? AuthStatus::Locked : AuthStatus::Backoff;
+        reply.retryAfterMs = limit.retryAfterMs;
+    }
+
+    // Applies finished hashes to the table.
+    void Collect() {
+        AuthResult r;
+        while (workers.Poll(r)) Finish(r);
+    }
+
+    void Enqueue(Waiting w) {
+        Collect();
+        if (waiting.empty() && Start(w)) return;
+        if (waiting.size() >= config.maxWaiting) {
+            AuthReply reply;
+            reply.tag = w.tag;
+            reply.status = AuthStatus::Busy;
+            if (w.job.kind == AuthJobKind::Verify) limiter.Release(w.job.username);
+            ready.push_back(reply);
+            return;
+        }
+        waiting.push_back(std::move(w));
+    }
+
+    // Looks the user up only now, so a login that waited sees registrations
+    // that finished meanwhile. Unknown users are hashed anyway, so the reply
+    // time doesn't tell.
+    bool Start(Waiting& w) {
+        if (w.job.kind == AuthJobKind::Verify) table.Find(w.job.username, w.job.credential);
+        uint64_t ticket = workers.Submit(w.job);
+        if (ticket == 0) return false;
+        started.emplace(ticket, Started{w.tag, std::move(w.source)});
+        return true;
+    }
+
+    void SubmitWaiting() {
+        while (!waiting.empty() && Start(waiting.front())) waiting.pop_front();
+    }
+
+    void Finish(const AuthResult& r) {
+        auto it = started.find(r.ticket);
+        if (it == started.end()) return;
+        AuthReply reply;
+        reply.tag = it->second.tag;
+        reply.ms = r.ms;
+        if (r.kind == AuthJobKind::Hash) {
+            TableStatus ts = r.ok ? table.Insert(r.username, r.credential) : TableStatus::IoError;
+            if (ts == TableStatus::Ok && !table.Sync()) ts = TableStatus::IoError;
+            reply.status = ts == TableStatus::Ok ? AuthStatus::Ok
+                         : ts == TableStatus::Exists ? AuthStatus::Exists
+                         : ts == TableStatus::TooLong ? AuthStatus::TooLong : AuthStatus::Error;
+        } else {
+            limiter.Settle(r.username, it->second.source, r.ok, LimiterNowMs());
+            // A plain-text or outdated hash is replaced after a successful login
+            if (r.ok && !r.credential.empty() && table.Update(r.username, r.credential) == TableStatus::Ok) table.Sync();
+            reply.status = r.ok ? AuthStatus::Ok : AuthStatus::Invalid;
+        }
+        started.erase(it);
+        ready.push_back(reply);
+    }
+
+    AuthConfig config;
+    CredentialTable table;
+    AuthWorkers workers;
+    LoginLimiter limiter;
+    bool open = false;
+    std::unordered_map<uint64_t, Started> started;  // by worker ticket
+    std::deque<Waiting> waiting;
+    std::deque<AuthReply> ready;
+};
+
+// ---------- Addresses ----------
+// A Unix domain socket path, or a localhost TCP port when `port` is set.
+struct ServiceAddress {
+    std::string socketPath = "login.sock";
+    int port = 0;
+
+    std::string ToString() const { return port ? "127.0.0.1:" + std::to_string(port) : socketPath; }
+};
+
+#ifndef _WIN32
+namespace service_detail {
+// Fills `sa` for `addr`; returns its length, or 0 if the path is too long.
+inline socklen_t MakeSockaddr(const ServiceAddress& addr, sockaddr_storage& sa) {
+    std::memset(&sa, 0, sizeof sa);
+    if (addr.port) {
+        sockaddr_in* in = (sockaddr_in*)&sa;
+        in->sin_family = AF_INET;
+        in->sin_port = htons((uint16_t)addr.port);
+        in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return sizeof(sockaddr_in);
+    }
+    sockaddr_un* un = (sockaddr_un*)&sa;
+    if (addr.socketPath.size() >= sizeof un->sun_path) return 0;
+    un->sun_family = AF_UNIX;
+    std::memcpy(un->sun_path, addr.socketPath.c_str(), addr.socketPath.size() + 1);
+    return sizeof(sockaddr_un);
+}
+
+inline void NoDelay(int fd, const ServiceAddress& addr) {
+    int one = 1;
+    if (addr.port) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+}
+
+// send() without SIGPIPE when the peer has gone.
+inline ssize_t SendSome(int fd, const char* data, size_t n) {
+#ifdef MSG_NOSIGNAL
+    return ::send(fd, data, n, MSG_NOSIGNAL);
+#else
+    return ::send(fd, data, n, 0);
+#endif
+}
+}  // namespace service_detail
+#endif
+
+// ---------- Auth Client ----------
+// One connection; replies come back in request order, so each carries the
+// tag Submit() returned for its request. Not thread-safe: one per thread.
+// Without socket support (Windows) Connect() always fails.
+class AuthClient {
+public:
+    AuthClient() = default;
+    ~AuthClient() { Close(); }
+
+    AuthClient(const AuthClient&) = delete;
+    AuthClient& operator=(const AuthClient&) = delete;
+
+    bool Connect(const ServiceAddress& addr) {
+        Close();
+#ifndef _WIN32
+        sockaddr_storage sa;
+        socklen_t len = service_detail::MakeSockaddr(addr, sa);
+        if (len == 0) return false;
+        fd = ::socket(sa.ss_family, SOCK_STREAM, 0);
+        if (fd < 0) return false;
+        if (::connect(fd, (sockaddr*)&sa, len) != 0) { Close(); return false; }
+#ifdef SO_NOSIGPIPE
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof one);
+#endif
+        service_detail::NoDelay(fd, addr);
+        return true;
+#else
+        (void)addr;
+        return false;
+#endif
+    }
+
+    bool Connected() const { return fd >= 0; }
+
+    // Sends the request and returns its tag, or 0 if it can't be sent.
+    uint64_t Submit(const AuthRequest& req) {
+        std::string line;
+        if (fd < 0 || !FormatRequest(req, line)) return 0;
+#ifndef _WIN32
+        for (size_t off = 0; off < line.size();) {
+            ssize_t n = service_detail::SendSome(fd, line.data() + off, line.size() - off);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) { Close(); return 0; }
+            off += (size_t)n;
+        }
+#endif
+        outstanding.push_back(++lastTag);
+        return lastTag;
+    }
+
+    // Takes a reply without blocking. If the connection drops, each request
+    // still outstanding gets an ERROR reply.
+    bool Poll(AuthReply& reply) { return Receive(reply, false); }
+
+    // Blocks until the next reply arrives.
+    bool Wait(AuthReply& reply) { return Receive(reply, true); }
+
+    // Round trip for one request.
+    bool Call(const AuthRequest& req, AuthReply& reply) { return Submit(req) && Wait(reply); }
+
+    void Close() {
+#ifndef _WIN32
+        if (fd >= 0) ::close(fd);
+#endif
+        fd = -1;
+        in.clear();
+    }
+
+private:
+    bool Receive(AuthReply& reply, bool block) {
+        for (;;) {
+            if (outstanding.empty()) return false;
+            size_t eol = in.find('\n');
+            if (eol != std::string::npos) {
+                reply = AuthReply();
+                if (!ParseReply(std::string_view(in).substr(0, eol), reply)) reply.status = AuthStatus::Error;
+                in.erase(0, eol + 1);
+                reply.tag = outstanding.front();
+                outstanding.pop_front();
+                return true;
+            }
+            if (fd < 0) {
+                reply = AuthReply();
+                reply.tag = outstanding.front();
+                outstanding.pop_front();
+                return true;
+            }
+#ifndef _WIN32
+            char buf[4096];
+            ssize_t n = ::recv(fd, buf, sizeof buf, block ? 0 : MSG_DONTWAIT);
+            if (n > 0) { in.append(buf, (size_t)n); continue; }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return false;
+#endif
+            Close();
+        }
+    }
+
+    int fd = -1;
+    std::string in;
+    std::deque<uint64_t> outstanding;
+    uint64_t lastTag = 0;
+};
+
+// ---------- Auth Server ----------
+#ifdef __linux__
+// Serves an AuthCore from one thread: an epoll loop over the listening
+// socket, the connections and an eventfd the hashing workers bump when a
+// result is ready. Each connection has at most one request in the core;
+// further lines wait in its input buffer, so replies stay in order.
+class AuthServer {
+public:
+    explicit AuthServer(AuthCore& core) : core(core) {}
+    ~AuthServer() { Shutdown(); }
+
+    AuthServer(const AuthServer&) = delete;
+    AuthServer& operator=(const AuthServer&) = delete;
+
+    // Binds and listens. A Unix socket path left behind by an earlier run
+    // is replaced.
+    bool Listen(const ServiceAddress& address) {
+        addr = address;
+        sockaddr_storage sa;
+        socklen_t len = service_detail::MakeSockaddr(addr, sa);
+        if (len == 0) return false;
+        listenFd = ::socket(sa.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) return false;
+        int one = 1;
+        if (addr.port) setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+        else ::unlink(addr.socketPath.c_str());
+        if (::bind(listenFd, (sockaddr*)&sa, len) != 0 || ::listen(listenFd, 512) != 0) return false;
+        bound = true;
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd < 0 || wakeFd < 0) return false;
+        Watch(listenFd, EPOLLIN, EPOLL_CTL_ADD);
+        Watch(wakeFd, EPOLLIN, EPOLL_CTL_ADD);
+        int wake = wakeFd;
+        core.OnResult([wake] { Bump(wake); });
+        return true;
+    }
+
+    // Runs until Stop().
+    void Run() {
+        epoll_event events[64];
+        while (!stopping.load()) {
+            int n = epoll_wait(epollFd, events, 64, -1);
+            if (n < 0 && errno != EINTR) break;
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) Accept();
+                else if (fd == wakeFd) { uint64_t v; while (::read(wakeFd, &v, sizeof v) > 0) {} }
+                else OnConnection(fd, events[i].events);
+            }
+            Deliver();
+        }
+    }
+
+    // From any thread, or a signal handler.
+    void Stop() {
+        stopping.store(true);
+        if (wakeFd >= 0) Bump(wakeFd);
+    }
+
+    size_t Connections() const { return conns.size(); }
+
+private:
+    struct Connection {
+        std::string source;     // limiter key: "uid:N" or the peer address
+        std::string in, out;
+        uint64_t busyTag = 0;   // the request in the core
+        bool watchingOut = false;
+    };
+
+    static void Bump(int fd) {
+        uint64_t one = 1;
+        ssize_t n = ::write(fd, &one, sizeof one);
+        (void)n;
+    }
+
+    void Watch(int fd, uint32_t events, int op) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, op, fd, &ev);
+    }
+
+    void Accept() {
+        for (;;) {
+            int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+            service_detail::NoDelay(fd, addr);
+            Connection& c = conns[fd];
+            c.source = PeerName(fd);
+            Watch(fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD);
+        }
+    }
+
+    std::string PeerName(int fd) const {
+        if (!addr.port) {
+            ucred cred{};
+            socklen_t len = sizeof cred;
+            if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0) return "uid:" + std::to_string(cred.uid);
+            return "unix";
+        }
+        sockaddr_in peer{};
+        socklen_t len = sizeof peer;
+        char text[INET_ADDRSTRLEN] = "?";
+        if (getpeername(fd, (sockaddr*)&peer, &len) == 0) inet_ntop(AF_INET, &peer.sin_addr, text, sizeof text);
+        return text;
+    }
+
+    void OnConnection(int fd, uint32_t events) {
+        auto it = conns.find(fd);
+        if (it == conns.end()) return;
+        Connection& c = it->second;
+        if (events & EPOLLOUT) {
+            if (!Flush(fd, c)) return Drop(fd);
+        }
+        if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            char buf[4096];
+            for (;;) {
+                ssize_t n = ::recv(fd, buf, sizeof buf, 0);
+                if (n > 0) { c.in.append(buf, (size_t)n); continue; }
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                return Drop(fd);                    // closed or failed
+            }
+            // A line that long isn't a request; don't buffer it forever
+            if (c.in.size() > 64 * MAX_REQUEST_LINE) return Drop(fd);
+            Next(fd, c);
+        }
+    }
+
+    // Hands the connection's next complete line to the core.
+    void Next(int fd, Connection& c) {
+        while (c.busyTag == 0) {
+            size_t eol = c.in.find('\n');
+            if (eol == std::string::npos) return;
+            std::string_view line = std::string_view(c.in).substr(0, eol);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            AuthRequest req;
+            bool parsed = eol <= MAX_REQUEST_LINE && ParseRequest(line, req);
+            c.in.erase(0, eol + 1);
+            if (!parsed) {
+                AuthReply bad;
+                bad.status = AuthStatus::Bad;
+                c.out += FormatReply(bad);
+                if (!Flush(fd, c)) return Drop(fd);
+                continue;
+            }
+            c.busyTag = ++lastTag;
+            owners[c.busyTag] = fd;
+            core.Submit(req, c.source, c.busyTag);
+        }
+    }
+
+    // Routes the core's finished replies to their connections.
+    void Deliver() {
+        AuthReply reply;
+        while (core.Poll(reply)) {
+            auto owner = owners.find(reply.tag);
+            if (owner == owners.end()) continue;
+            int fd = owner->second;
+            owners.erase(owner);
+            auto it = conns.find(fd);
+            if (it == conns.end() || it->second.busyTag != reply.tag) continue;
+            Connection& c = it->second;
+            c.busyTag = 0;
+            c.out += FormatReply(reply);
+            if (!Flush(fd, c)) { Drop(fd); continue; }
+            Next(fd, c);
+        }
+    }
+
+    // Writes what the socket takes now and watches for room for the rest.
+    bool Flush(int fd, Connection& c) {
+        size_t off = 0;
+        while (off < c.out.size()) {
+            ssize_t n = service_detail::SendSome(fd, c.out.data() + off, c.out.size() - off);
+            if (n > 0) { off += (size_t)n; continue; }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            return false;
+        }
+        c.out.erase(0, off);
+        bool wantOut = !c.out.empty();
+        if (wantOut != c.watchingOut) {
+            Watch(fd, EPOLLIN | EPOLLRDHUP | (wantOut ? (uint32_t)EPOLLOUT : 0u), EPOLL_CTL_MOD);
+            c.watchingOut = wantOut;
+        }
+        return true;
+    }
+
+    // A request still in the core finishes anyway; its reply is dropped.
+    void Drop(int fd) {
+        auto it = conns.find(fd);
+        if (it == conns.end()) return;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        conns.erase(it);
+    }
+
+    void Shutdown() {
+        while (!conns.empty()) Drop(conns.begin()->first);
+        if (listenFd >= 0) ::close(listenFd);
+        if (bound && !addr.port) ::unlink(addr.socketPath.c_str());
+        if (epollFd >= 0) ::close(epollFd);
+        if (wakeFd >= 0) ::close(wakeFd);
+        listenFd = epollFd = wakeFd = -1;
+        bound = false;
+    }
+
+    AuthCore& core;
+    ServiceAddress addr;
+    int listenFd = -1, epollFd = -1, wakeFd = -1;
+    bool bound = false;
+    std::atomic<bool> stopping{false};
+    std::unordered_map<int, Connection> conns;
+    std::unordered_map<uint64_t, int> owners;   // request tag -> connection fd
+    uint64_t lastTag = 0;
+};
+#endif
@@ -1,36 +1,68 @@
 #include <raylib.h>
-#include <fstream>
 #include <string>
 #include <cctype>
+#include "LoginService.h"
+
+// Cost of new password hashes (16 MB and roughly 50 ms each at logN 14);
+// `login_tool kdf` times other settings. Existing hashes keep their own.
+KdfParams hashParams;
+
+AuthConfig LocalConfig() {
+    AuthConfig config;
+    config.params = hashParams;
+    config.threads = 2;     // at most 2 hashes run at once and 8 wait
+    config.maxPending = 8;
+    return config;
+}
 
-// Save credentials to file
-bool RegisterUser(const std::string &username, const std::string &password) {
-    std::ifstream infile("users.txt");
-    std::string u, p;
-    while (infile >> u >> p) {
-        if (u == username) return false; 
+// The window is a client of login_service when one is listening on
+// login.sock; otherwise it serves itself from users.db with the same core
+AuthClient service;
+AuthCore local(LocalConfig());
+bool remote = false;
+uint64_t localTag = 0;
+
+// Connects to the service or opens the local core; returns a message
+std::string ConnectAuth() {
+    if (service.Connect(ServiceAddress())) {
+        remote = true;
+        return "Connected to login_service";
     }
-    infile.close();
+    return local.Open();
+}
+
+// Queue a register or login request; the reply arrives through PollReply
+uint64_t SubmitRequest(AuthOp op, const std::string &username, const std::string &password) {
+    AuthRequest req{op, username, password};
+    if (remote) return service.Submit(req);
+    local.Submit(req, "local", ++localTag);
+    return localTag;
+}
 
-    std::ofstream outfile("users.txt", std::ios::app);
-    outfile << username << " " << password << "\n";
-    outfile.close();
-    return true;
+bool PollReply(AuthReply &reply) {
+    return remote ? service.Poll(reply) : local.Poll(reply);
 }
 
-// Verify credentials
-bool LoginUser(const std::string &username, const std::string &password) {
-    std::ifstream infile("users.txt");
-    std::string u, p;
-    while (infile >> u >> p) {
-        if (u == username && p == password) return true;
+// What the form shows for a reply
+std::string ReplyMessage(const AuthReply &reply, bool registering) {
+    switch (reply.status) {
+        case AuthStatus::Ok:
+            return TextFormat("%s (%.0f ms)", registering ? "Registered successfully!" : "Login successful!", reply.ms);
+        case AuthStatus::Invalid: return "Invalid credentials!";
+        case AuthStatus::Exists: return "Username already exists!";
+        case AuthStatus::TooLong: return "Username too long!";
+        case AuthStatus::Empty: return "Fill both fields!";
+        case AuthStatus::Backoff: return TextFormat("Too many attempts, wait %lld s", (long long)(reply.retryAfterMs + 999) / 1000);
+        case AuthStatus::Locked: return TextFormat("Locked out, wait %lld s", (long long)(reply.retryAfterMs + 999) / 1000);
+        case AuthStatus::Busy: return "Busy, try again!";
+        default: return remote && !service.Connected() ? "Lost connection to login_service!" : "Something went wrong!";
     }
-    return false;
 }
 
 int main() {
     InitWindow(600, 400, "Login & Registration System");
     SetTargetFPS(60);
+    std::string openMessage = ConnectAuth();
 
     std::string username = "";
     std::string password = "";
@@ -38,7 +70,8 @@ int main() {
     bool passwordActive = false;
 
     bool showRegister = true;
-    std::string message = "";
+    std::string message = openMessage;
+    uint64_t pendingTicket = 0;     // the request the form is waiting for
 
     while (!WindowShouldClose()) {
         // --- Handle input focus ---
@@ -72,32 +105,26 @@ int main() {
     }
 
         // --- Handle Enter key ---
-        if (IsKeyPressed(KEY_ENTER)) {
-            if (showRegister) {
-                if (!username.empty() && !password.empty()) {
-                    if (RegisterUser(username, password)) {
-                        message = "Registered successfully!";
-                        username.clear();
-                        password.clear();
-                    } else {
-                        message = "Username already exists!";
-                    }
-                } else {
-                    message = "Fill both fields!";
-                }
-            } else {
-                if (LoginUser(username, password)) {
-                    message = "Login successful!";
-                    username.clear();
-                    password.clear();
-                } else {
-                    message = "Invalid credentials!";
-                }
+        if (IsKeyPressed(KEY_ENTER) && pendingTicket == 0) {
+            pendingTicket = SubmitRequest(showRegister ? AuthOp::Register : AuthOp::Login, username, password);
+            if (!pendingTicket) message = "Lost connection to login_service!";
+            else message = showRegister ? "Registering..." : "Checking...";
+        }
+
+        // --- Collect replies ---
+        AuthReply reply;
+        while (PollReply(reply)) {
+            if (reply.tag != pendingTicket) continue;
+            pendingTicket = 0;
+            message = ReplyMessage(reply, showRegister);
+            if (reply.status == AuthStatus::Ok) {
+                username.clear();
+                password.clear();
             }
         }
 
         // --- Switch Register/Login ---
-        if (IsKeyPressed(KEY_TAB)) {
+        if (IsKeyPressed(KEY_TAB) && pendingTicket == 0) {
             showRegister = !showRegister;
             message = showRegister ? "Switched to Register" : "Switched to Login";
         }
@@ -126,6 +153,8 @@ int main() {
         EndDrawing();
     }
 
+    service.Close();
+    local.Close();
     CloseWindow();
     return 0;
 }
\ No newline at end of file
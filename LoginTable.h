@@ -0,0 +1,507 @@
+// Binary credential store: a fixed-bucket hash table on disk. Each bucket is
+// one 4 KB page of 16 fixed 256-byte slots, so finding, adding or removing
+// a user reads one page and writes one slot, and changing one writes two
+// (more only when a bucket has overflowed into the next). Names may hold
+// any byte, spaces included. No raylib dependency.
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "LoginIndex.h"
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ------------------- Block File -------------------
+// Positional reads and writes (pread/pwrite), no shared file offset.
+class BlockFile {
+public:
+    BlockFile()=default;
+    ~BlockFile() { Close(); }
+
+    BlockFile(const BlockFile&)=delete;
+    BlockFile &operator=(const BlockFile&)=delete;
+
+    bool Open(const std::string &path, bool create) {
+        Close();
+#if defined(_WIN32)
+        h=CreateFileA(path.c_str(),GENERIC_READ|GENERIC_WRITE,FILE_SHARE_READ,nullptr,create ? OPEN_ALWAYS : OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+        return h!=INVALID_HANDLE_VALUE;
+#else
+        fd=open(path.c_str(),O_RDWR|(create ? O_CREAT : 0),0600);
+        return fd>=0;
+#endif
+    }
+
+    void Close() {
+#if defined(_WIN32)
+        if (h!=INVALID_HANDLE_VALUE) CloseHandle(h);
+        h=INVALID_HANDLE_VALUE;
+#else
+        if (fd>=0) close(fd);
+        fd=-1;
+#endif
+    }
+
+    bool IsOpen() const {
+#if defined(_WIN32)
+        return h!=INVALID_HANDLE_VALUE;
+#else
+        return fd>=0;
+#endif
+    }
+
+    uint64_t Size() const {
+#if defined(_WIN32)
+        LARGE_INTEGER len;
+        return GetFileSizeEx(h,&len) ? (uint64_t)len.QuadPart : 0;
+#else
+        struct stat st;
+        return fstat(fd,&st)==0 ? (uint64_t)st.st_size : 0;
+#endif
+    }
+
+    // Reading past the end yields zeros (an empty slot).
+    bool ReadAt(uint64_t off, void *buf, size_t n) const {
+        uint8_t *p=(uint8_t*)buf;
+        while (n>0) {
+#if defined(_WIN32)
+            OVERLAPPED o{};
+            o.Offset=(DWORD)off; o.OffsetHigh=(DWORD)(off>>32);
+            DWORD got=0;
+            if (!ReadFile(h,p,(DWORD)std::min<size_t>(n,1<<30),&got,&o) && GetLastError()!=ERROR_HANDLE_EOF) return false;
+#else
+            ssize_t got=pread(fd,p,n,(off_t)off);
+            if (got<0) return false;
+#endif
+            if (got==0) { std::memset(p,0,n); return true; }
+            p+=got; off+=got; n-=(size_t)got;
+        }
+        return true;
+    }
+
+    bool WriteAt(uint64_t off, const void *buf, size_t n) {
+        const uint8_t *p=(const uint8_t*)buf;
+        while (n>0) {
+#if defined(_WIN32)
+            OVERLAPPED o{};
+            o.Offset=(DWORD)off; o.OffsetHigh=(DWORD)(off>>32);
+            DWORD put=0;
+            if (!WriteFile(h,p,(DWORD)std::min<size_t>(n,1<<30),&put,&o)) return false;
+#else
+            ssize_t put=pwrite(fd,p,n,(off_t)off);
+            if (put<=0) return false;
+#endif
+            p+=put; off+=put; n-=(size_t)put;
+        }
+        return true;
+    }
+
+    bool Sync() {
+#if defined(_WIN32)
+        return FlushFileBuffers(h)!=0;
+#elif defined(__APPLE__)
+        return fsync(fd)==0;
+#else
+        return fdatasync(fd)==0;
+#endif
+    }
+
+private:
+#if defined(_WIN32)
+    HANDLE h=INVALID_HANDLE_VALUE;
+#else
+    int fd=-1;
+#endif
+};
+
+// ------------------- Format -------------------
+// Page 0 is the header; bucket b is page b+1. A user's home bucket comes
+// from the name's hash; a full bucket overflows into the next one (wrapping
+// at the end). Removed users leave a tombstone so longer probe chains stay
+// intact; Compact() drops them. An update writes the user's new slot before
+// retiring the old one, so no single torn write can lose a user.
+struct CredentialTableHeader {
+    char magic[4];              // "LGCT"
+    uint32_t version;
+    uint32_t bucketBits;
+    uint32_t slotSize;
+    uint64_t live, dead;        // exact only when `clean`
+    uint32_t clean;             // 0 while open for writing: recount on open
+    uint32_t crc;               // of the fields above
+};
+
+struct CredentialSlot {
+    static constexpr uint8_t EMPTY = 0, LIVE = 1, DEAD = 2;
+    uint32_t crc;               // of the bytes after it; a torn write reads as a tombstone
+    uint8_t state;
+    uint8_t nameLen;
+    uint8_t credentialLen;
+    uint8_t version;            // bumped by each Update(); the newer copy wins after a crash
+    uint64_t hash;              // HashName(name)
+    char name[64];
+    char credential[176];
+};
+static_assert(sizeof(CredentialSlot)==256, "CredentialSlot must stay 256 bytes");
+
+constexpr uint32_t CREDENTIAL_TABLE_VERSION = 1;
+
+enum class TableStatus { Ok, Exists, NotFound, TooLong, IoError };
+
+// ------------------- Credential Table -------------------
+class CredentialTable {
+public:
+    static constexpr size_t PAGE = 4096, SLOTS = PAGE/sizeof(CredentialSlot);
+    static constexpr size_t MAX_NAME = sizeof(CredentialSlot::name), MAX_CREDENTIAL = sizeof(CredentialSlot::credential);
+    static constexpr int MIN_BITS = 6;
+
+    CredentialTable()=default;
+    ~CredentialTable() { Close(); }
+
+    CredentialTable(const CredentialTable&)=delete;
+    CredentialTable &operator=(const CredentialTable&)=delete;
+
+    // Opens `path`, creating an empty table if it doesn't exist. After a
+    // crash the counts are rebuilt with one sequential pass.
+    bool Open(const std::string &path) {
+        Close();
+        this->path=path;
+        dirty=false;
+        if (!file.Open(path,true)) return false;
+        if (file.Size()==0) {
+            bits=MIN_BITS; live=dead=0;
+            return WriteHeader(true) && file.Sync();
+        }
+        CredentialTableHeader h;
+        if (!file.ReadAt(0,&h,sizeof h) || std::memcmp(h.magic,"LGCT",4)!=0 || h.version!=CREDENTIAL_TABLE_VERSION
+            || h.slotSize!=sizeof(CredentialSlot) || h.crc!=HeaderCrc(h) || h.bucketBits<MIN_BITS || h.bucketBits>32) { file.Close(); return false; }
+        bits=(int)h.bucketBits; live=h.live; dead=h.dead;
+        if (!h.clean && !Recount()) { file.Close(); return false; }
+        return true;
+    }
+
+    // Records the counts so the next Open() needn't scan.
+    void Close() {
+        if (!file.IsOpen()) return;
+        if (dirty && WriteHeader(true)) file.Sync();
+        file.Close();
+        dirty=false;
+    }
+
+    bool IsOpen() const { return file.IsOpen(); }
+
+    bool Find(std::string_view name, std::string &credential) {
+        Probe p;
+        if (Locate(name,p)!=TableStatus::Ok) return false;
+        credential.assign(p.page[p.slot].credential,p.page[p.slot].credentialLen);
+        return true;
+    }
+
+    // Adds a user; grows the table (a full rewrite, amortised O(1)) when
+    // it is three quarters full.
+    TableStatus Insert(std::string_view name, std::string_view credential) {
+        if (name.size()>MAX_NAME || credential.size()>MAX_CREDENTIAL) return TableStatus::TooLong;
+        if ((live+dead+1)*4>Capacity()*3 && !Compact(BitsFor(live+1))) return TableStatus::IoError;
+        Probe p;
+        TableStatus s=Locate(name,p);
+        if (s!=TableStatus::NotFound) return s==TableStatus::Ok ? TableStatus::Exists : s;
+        if (p.freeBucket==NONE) {   // every slot taken
+            if (!Compact(bits+1)) return TableStatus::IoError;
+            return Insert(name,credential);
+        }
+        CredentialSlot slot=MakeSlot(name,credential);
+        if (!BeginWrite() || !file.WriteAt(SlotOffset(p.freeBucket,p.freeSlot),&slot,sizeof slot)) return TableStatus::IoError;
+        if (p.freeReusesTombstone) dead--;
+        live++;
+        return TableStatus::Ok;
+    }
+
+    // Replaces a user's credential (password change, rehash). The new slot
+    // goes to a free slot on the chain and is synced before the old one
+    // becomes a tombstone: a crash in between leaves both, and Recount()
+    // keeps the newer.
+    TableStatus Update(std::string_view name, std::string_view credential) {
+        if (credential.size()>MAX_CREDENTIAL) return TableStatus::TooLong;
+        if ((live+dead+1)*4>Capacity()*3 && !Compact(BitsFor(live+1))) return TableStatus::IoError;
+        Probe p;
+        TableStatus s=Locate(name,p);
+        if (s!=TableStatus::Ok) return s;
+        CredentialSlot old=p.page[p.slot];
+        uint64_t oldBucket=p.bucket;
+        size_t oldSlot=p.slot;
+        if (p.freeBucket==NONE && !FreeAfter(p)) return TableStatus::IoError;
+        if (p.freeBucket==NONE) {   // every slot taken
+            if (!Compact(bits+1)) return TableStatus::IoError;
+            return Update(name,credential);
+        }
+        CredentialSlot slot=MakeSlot(name,credential);
+        slot.version=(uint8_t)(old.version+1);
+        slot.crc=SlotCrc(slot);
+        old.state=CredentialSlot::DEAD;
+        old.crc=SlotCrc(old);
+        if (!BeginWrite() || !file.WriteAt(SlotOffset(p.freeBucket,p.freeSlot),&slot,sizeof slot) || !file.Sync()
+            || !file.WriteAt(SlotOffset(oldBucket,oldSlot),&old,sizeof old)) return TableStatus::IoError;
+        if (!p.freeReusesTombstone) dead++;
+        return TableStatus::Ok;
+    }
+
+    TableStatus Erase(std::string_view name) {
+        Probe p;
+        TableStatus s=Locate(name,p);
+        if (s!=TableStatus::Ok) return s;
+        CredentialSlot slot=p.page[p.slot];
+        slot.state=CredentialSlot::DEAD;
+        slot.crc=SlotCrc(slot);
+        if (!BeginWrite() || !file.WriteAt(SlotOffset(p.bucket,p.slot),&slot,sizeof slot)) return TableStatus::IoError;
+        live--; dead++;
+        return TableStatus::Ok;
+    }
+
+    // Makes every change so far durable.
+    bool Sync() { return file.Sync(); }
+
+    // Rewrites the table with only live users into <path>.tmp, sized for
+    // 2^newBits buckets (0: half full), fsyncs it and renames it over the
+    // original, so a crash leaves either the old table or the new one.
+    // Users are sorted by their new home bucket and the new pages written
+    // in order, each once.
+    bool Compact(int newBits=0) {
+        if (newBits<=0) newBits=BitsFor(live);
+        newBits=std::max(newBits,BitsFor(live));
+        std::vector<Move> moves;
+        if (!CollectMoves(newBits,moves)) return false;
+        std::string tmp=path+".tmp";
+        std::remove(tmp.c_str());
+        {
+            CredentialTable out;
+            if (!out.Open(tmp)) return false;
+            out.bits=newBits;
+            bool ok=out.WriteHeader(false);
+            // A bucket takes the waiting users whose home is at or before it;
+            // any still waiting after the last bucket wrap around to the first.
+            std::vector<CredentialSlot> page(SLOTS);
+            size_t next=0;
+            for (uint64_t b=0;ok && b<out.Buckets() && next<moves.size();b++) {
+                size_t used=0;
+                for (;used<SLOTS && next<moves.size() && moves[next].home<=b;used++,next++)
+                    ok=ok && file.ReadAt(moves[next].offset,&page[used],sizeof(CredentialSlot));
+                if (used==0) continue;
+                std::memset((void*)&page[used],0,(SLOTS-used)*sizeof(CredentialSlot));
+                ok=ok && out.file.WriteAt(PageOffset(b),page.data(),PAGE);
+                out.live+=used;
+            }
+            for (;ok && next<moves.size();next++)
+                ok=file.ReadAt(moves[next].offset,&page[0],sizeof(CredentialSlot)) && out.Place(page[0]);
+            ok=ok && out.WriteHeader(true) && out.file.Sync();
+            out.file.Close();
+            if (!ok) { std::remove(tmp.c_str()); return false; }
+        }
+        file.Close();   // the old counts die with the old file
+#if defined(_WIN32)
+        std::remove(path.c_str());   // rename() won't replace on Windows
+#endif
+        if (std::rename(tmp.c_str(),path.c_str())!=0) {
+            std::remove(tmp.c_str());
+            Open(path);
+            return false;
+        }
+        return Open(path);
+    }
+
+    // Calls fn(name, credential) for every user, in bucket order.
+    template <typename Fn>
+    bool ForEach(Fn fn) {
+        std::vector<CredentialSlot> page(SLOTS);
+        for (uint64_t b=0;b<Buckets();b++) {
+            if (!file.ReadAt(PageOffset(b),page.data(),PAGE)) return false;
+            for (const CredentialSlot &s: page)
+                if (IsLive(s)) fn(std::string_view(s.name,s.nameLen),std::string_view(s.credential,s.credentialLen));
+        }
+        return true;
+    }
+
+    size_t Size() const { return (size_t)live; }
+    size_t Tombstones() const { return (size_t)dead; }
+    uint64_t Buckets() const { return uint64_t(1)<<bits; }
+    uint64_t Capacity() const { return Buckets()*SLOTS; }
+
+private:
+    static constexpr uint64_t NONE = ~uint64_t(0);
+
+    struct Move {
+        uint64_t home;          // bucket in the new table
+        uint64_t offset;        // slot in this file
+        bool operator<(const Move &o) const { return home!=o.home ? home<o.home : offset<o.offset; }
+    };
+
+    struct Probe {
+        CredentialSlot page[SLOTS];
+        uint64_t bucket=0;      // where the match is
+        size_t slot=0;
+        uint64_t freeBucket=NONE;   // first reusable slot on the chain
+        size_t freeSlot=0;
+        bool freeReusesTombstone=false;
+    };
+
+    static uint32_t SlotCrc(const CredentialSlot &s) { return (uint32_t)HashName(std::string_view((const char*)&s+4,sizeof s-4)); }
+    static uint32_t HeaderCrc(const CredentialTableHeader &h) { return (uint32_t)HashName(std::string_view((const char*)&h,offsetof(CredentialTableHeader,crc))); }
+    // Checks the slot's crc; lookups only do so once the name hash matches.
+    static bool IsLive(const CredentialSlot &s) { return s.state==CredentialSlot::LIVE && s.crc==SlotCrc(s); }
+
+    // Smallest table holding `users` at most half full.
+    static int BitsFor(uint64_t users) {
+        int b=MIN_BITS;
+        while ((uint64_t(1)<<b)*SLOTS<users*2) b++;
+        return b;
+    }
+
+    static CredentialSlot MakeSlot(std::string_view name, std::string_view credential) {
+        CredentialSlot s;
+        std::memset(&s,0,sizeof s);
+        s.state=CredentialSlot::LIVE;
+        s.nameLen=(uint8_t)name.size();
+        s.credentialLen=(uint8_t)credential.size();
+        s.hash=HashName(name);
+        std::memcpy(s.name,name.data(),name.size());
+        std::memcpy(s.credential,credential.data(),credential.size());
+        s.crc=SlotCrc(s);
+        return s;
+    }
+
+    static uint64_t HomeIn(uint64_t hash, int bits) { return (hash*0x9E3779B97F4A7C15ull)>>(64-bits); }
+    uint64_t Home(uint64_t hash) const { return HomeIn(hash,bits); }
+    static uint64_t PageOffset(uint64_t bucket) { return (bucket+1)*PAGE; }
+    static uint64_t SlotOffset(uint64_t bucket, size_t slot) { return PageOffset(bucket)+slot*sizeof(CredentialSlot); }
+
+    // Walks the chain from the name's home bucket until the name or an empty
+    // slot turns up, noting the first slot an insert could take. Ok: found
+    // at p.bucket/p.slot, whose page is in p.page.
+    TableStatus Locate(std::string_view name, Probe &p) {
+        uint64_t hash=HashName(name);
+        uint64_t b=Home(hash);
+        for (uint64_t n=0;n<Buckets();n++,b=(b+1)&(Buckets()-1)) {
+            if (!file.ReadAt(PageOffset(b),p.page,PAGE)) return TableStatus::IoError;
+            for (size_t i=0;i<SLOTS;i++) {
+                const CredentialSlot &s=p.page[i];
+                if (s.state==CredentialSlot::LIVE && s.hash==hash && s.nameLen==name.size()
+                    && std::memcmp(s.name,name.data(),name.size())==0 && IsLive(s)) {
+                    p.bucket=b; p.slot=i;
+                    return TableStatus::Ok;
+                }
+                if (s.state!=CredentialSlot::LIVE && p.freeBucket==NONE) {
+                    p.freeBucket=b; p.freeSlot=i; p.freeReusesTombstone=s.state==CredentialSlot::DEAD;
+                }
+                if (s.state==CredentialSlot::EMPTY) return TableStatus::NotFound;
+            }
+        }
+        return TableStatus::NotFound;
+    }
+
+    // After Locate() found the name with no free slot ahead of it: the first
+    // free slot past it on the chain. False only on a read error.
+    bool FreeAfter(Probe &p) {
+        uint64_t b=p.bucket;
+        size_t from=p.slot+1;
+        for (uint64_t n=0;n<Buckets();n++,b=(b+1)&(Buckets()-1),from=0) {
+            if (n>0 && !file.ReadAt(PageOffset(b),p.page,PAGE)) return false;
+            for (size_t i=from;i<SLOTS;i++)
+                if (p.page[i].state!=CredentialSlot::LIVE) {
+                    p.freeBucket=b; p.freeSlot=i; p.freeReusesTombstone=p.page[i].state==CredentialSlot::DEAD;
+                    return true;
+                }
+        }
+        return true;
+    }
+
+    // Compaction: adds a slot known not to be present.
+    bool Place(const CredentialSlot &s) {
+        CredentialSlot page[SLOTS];
+        uint64_t b=Home(s.hash);
+        for (uint64_t n=0;n<Buckets();n++,b=(b+1)&(Buckets()-1)) {
+            if (!file.ReadAt(PageOffset(b),page,PAGE)) return false;
+            for (size_t i=0;i<SLOTS;i++)
+                if (page[i].state==CredentialSlot::EMPTY) { live++; return file.WriteAt(SlotOffset(b,i),&s,sizeof s); }
+        }
+        return false;
+    }
+
+    bool WriteHeader(bool clean) {
+        CredentialTableHeader h{{'L','G','C','T'},CREDENTIAL_TABLE_VERSION,(uint32_t)bits,(uint32_t)sizeof(CredentialSlot),live,dead,clean ? 1u : 0u,0};
+        h.crc=HeaderCrc(h);
+        return file.WriteAt(0,&h,sizeof h);
+    }
+
+    // The first change after opening marks the header unclean.
+    bool BeginWrite() {
+        if (dirty) return true;
+        dirty=WriteHeader(false);
+        return dirty;
+    }
+
+    // Every live user's slot and home in a table of 2^newBits buckets, in
+    // new-table order. One sequential read.
+    bool CollectMoves(int newBits, std::vector<Move> &moves) {
+        moves.clear();
+        moves.reserve((size_t)live);
+        std::vector<CredentialSlot> chunk(SLOTS*64);
+        for (uint64_t b=0;b<Buckets();b+=64) {
+            size_t pages=(size_t)std::min<uint64_t>(64,Buckets()-b);
+            if (!file.ReadAt(PageOffset(b),chunk.data(),pages*PAGE)) return false;
+            for (size_t i=0;i<pages*SLOTS;i++)
+                if (IsLive(chunk[i])) moves.push_back(Move{HomeIn(chunk[i].hash,newBits),PageOffset(b)+i*sizeof(CredentialSlot)});
+        }
+        std::sort(moves.begin(),moves.end());
+        return true;
+    }
+
+    // After a crash: counts users and tombstones (torn slots count as
+    // tombstones) with one sequential read, and retires the older copy of
+    // any user an interrupted Update() left twice.
+    bool Recount() {
+        live=dead=0;
+        std::vector<std::pair<uint64_t,uint64_t>> seen;    // {hash, slot offset} of live slots
+        seen.reserve((size_t)std::min<uint64_t>(Capacity(),1u<<20));
+        std::vector<CredentialSlot> chunk(SLOTS*64);
+        for (uint64_t b=0;b<Buckets();b+=64) {
+            size_t pages=(size_t)std::min<uint64_t>(64,Buckets()-b);
+            if (!file.ReadAt(PageOffset(b),chunk.data(),pages*PAGE)) return false;
+            for (size_t i=0;i<pages*SLOTS;i++) {
+                if (IsLive(chunk[i])) { live++; seen.emplace_back(chunk[i].hash,PageOffset(b)+i*sizeof(CredentialSlot)); }
+                else if (chunk[i].state!=CredentialSlot::EMPTY) dead++;
+            }
+        }
+        std::sort(seen.begin(),seen.end());
+        CredentialSlot a, c;
+        for (size_t i=1;i<seen.size();i++) {
+            if (seen[i].first!=seen[i-1].first) continue;
+            if (!file.ReadAt(seen[i-1].second,&a,sizeof a) || !file.ReadAt(seen[i].second,&c,sizeof c)) return false;
+            if (!IsLive(a) || !IsLive(c) || a.nameLen!=c.nameLen || std::memcmp(a.name,c.name,a.nameLen)!=0) continue;
+            bool keepA=(int8_t)(a.version-c.version)>0;
+            CredentialSlot &loser=keepA ? c : a;
+            loser.state=CredentialSlot::DEAD;
+            loser.crc=SlotCrc(loser);
+            if (!file.WriteAt(keepA ? seen[i].second : seen[i-1].second,&loser,sizeof loser)) return false;
+            live--; dead++;
+            if (keepA) seen[i]=seen[i-1];   // compare a third copy against the winner
+        }
+        dirty=true;     // the header is rewritten with the new counts on Close()
+        return true;
+    }
+
+    std::string path;
+    BlockFile file;
+    int bits=MIN_BITS;
+    uint64_t live=0, dead=0;
+    bool dirty=false;
+};
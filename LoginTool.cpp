@@ -0,0 +1,759 @@
+// Headless login tools built on the core headers (no raylib).
+//   bench  writes a large users.txt, then times loading it into the
+//          credential index, logins (hits and misses) and registrations,
+//          checks every answer, and compares with the old per-login scan.
+//   kdf    checks the scrypt implementation against RFC 7914, times one
+//          hash at the chosen cost and verification throughput through the
+//          worker pool.
+//   table  times the on-disk credential table: inserts, lookups, updates,
+//          deletes, reopening after a crash and compaction.
+//   import copies a users.txt into a credential table.
+//   compact rewrites a credential table without its tombstones.
+//   limit  checks the attempt limiter's backoff and lockout rules, then
+//          times it under a synthetic credential-stuffing attack.
+//   load   drives the authentication service with concurrent clients and
+//          reports logins/sec and latency percentiles.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LoginCore.h"
+#include "LoginLimiter.h"
+#include "LoginService.h"
+#include "LoginWorkers.h"
+
+static double NsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Nearest-rank percentile of an ascending vector.
+template <typename T>
+static T Percentile(const std::vector<T>& sorted, double p) {
+    if (sorted.empty()) return T{};
+    size_t rank = (size_t)std::ceil(p / 100.0 * sorted.size());
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+static std::string RandomToken(std::mt19937_64& rng, size_t minLen, size_t maxLen) {
+    static const char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+    std::string s(minLen + rng() % (maxLen - minLen + 1), ' ');
+    for (char& ch : s) ch = chars[rng() % (sizeof(chars) - 1)];
+    return s;
+}
+
+// Username i: a random stem plus the index, so every name is distinct.
+static std::string UserName(std::mt19937_64& rng, size_t i) { return RandomToken(rng, 3, 8) + std::to_string(i); }
+
+// The lookup every login used to do: stream the whole file.
+static bool ScanLogin(const std::string& path, const std::string& username, const std::string& password) {
+    std::ifstream infile(path);
+    std::string u, p;
+    while (infile >> u >> p) {
+        if (u == username && p == password) return true;
+    }
+    return false;
+}
+
+// ---------- Bench ----------
+struct BenchOptions {
+    std::string path = "bench_users.txt";
+    size_t users = 1000000;
+    size_t lookups = 1000000;
+    size_t registrations = 100000;
+    size_t scans = 5;           // logins timed with the old full-file scan
+    bool keep = false;          // leave the generated file behind
+};
+
+static void PrintLatency(const char* label, std::vector<uint32_t>& ns) {
+    std::sort(ns.begin(), ns.end());
+    double sum = 0;
+    for (uint32_t v : ns) sum += v;
+    std::printf("%-12s %zu, mean %.0f ns, p50 %u ns, p99 %u ns, p99.9 %u ns, max %u ns\n", label, ns.size(),
+                ns.empty() ? 0.0 : sum / ns.size(), Percentile(ns, 50), Percentile(ns, 99), Percentile(ns, 99.9),
+                ns.empty() ? 0u : ns.back());
+}
+
+static bool RunBench(const BenchOptions& opt) {
+    std::mt19937_64 rng(0x10c1);
+    std::vector<std::string> names(opt.users), passwords(opt.users);
+    FILE* f = std::fopen(opt.path.c_str(), "wb");
+    if (!f) { std::fprintf(stderr, "cannot write %s\n", opt.path.c_str()); return false; }
+    for (size_t i = 0; i < opt.users; ++i) {
+        names[i] = UserName(rng, i);
+        passwords[i] = RandomToken(rng, 8, 14);
+        std::fprintf(f, "%s %s\n", names[i].c_str(), passwords[i].c_str());
+    }
+    long fileBytes = std::ftell(f);
+    if (std::fclose(f) != 0) { std::fprintf(stderr, "cannot write %s\n", opt.path.c_str()); return false; }
+    bool ok = true;
+
+    UserStore store(opt.path);
+    auto t0 = std::chrono::steady_clock::now();
+    if (!store.Load()) { std::fprintf(stderr, "cannot read %s\n", opt.path.c_str()); return false; }
+    double loadMs = NsSince(t0) / 1e6;
+    if (store.Size() != opt.users) ok = false;
+
+    // Credentials here are plain passwords, so the timings show the index,
+    // not the KDF (see kdf). Half the logins use a real user's password, a quarter a wrong password
+    // and a quarter a name that doesn't exist.
+    std::uniform_int_distribution<size_t> pick(0, opt.users - 1);
+    std::vector<uint32_t> hitNs, missNs;
+    hitNs.reserve(opt.lookups / 2 + 1);
+    missNs.reserve(opt.lookups / 2 + 1);
+    for (size_t q = 0; q < opt.lookups; ++q) {
+        size_t i = pick(rng);
+        std::string name = q % 4 == 3 ? "nobody" + std::to_string(q) : names[i];
+        std::string pass = q % 4 == 2 ? passwords[i] + "x" : passwords[i];
+        auto q0 = std::chrono::steady_clock::now();
+        bool in = store.Login(name, pass);
+        uint32_t ns = (uint32_t)std::min<double>(NsSince(q0), UINT32_MAX);
+        if (in != (q % 4 < 2)) ok = false;
+        (in ? hitNs : missNs).push_back(ns);
+    }
+
+    std::vector<std::string> added;
+    added.reserve(opt.registrations);
+    t0 = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < opt.registrations; ++k) {
+        added.push_back(UserName(rng, opt.users + k));
+        if (!store.Register(added.back(), "pw" + std::to_string(k))) ok = false;
+    }
+    if (store.Register(names[0], "again")) ok = false;   // name taken
+    double registerNs = NsSince(t0) / std::max<size_t>(opt.registrations, 1);
+    t0 = std::chrono::steady_clock::now();
+    store.Flush();
+    double flushMs = NsSince(t0) / 1e6;
+
+    // What a restart sees.
+    UserStore reread(opt.path);
+    ok = ok && reread.Load() && reread.Size() == opt.users + opt.registrations;
+    for (size_t k = 0; ok && k < added.size(); k += 97) ok = reread.Login(added[k], "pw" + std::to_string(k));
+
+    double scanMs = 0;
+    for (size_t s = 0; s < opt.scans; ++s) {
+        size_t i = pick(rng);
+        t0 = std::chrono::steady_clock::now();
+        if (!ScanLogin(opt.path, names[i], passwords[i])) ok = false;
+        scanMs += NsSince(t0) / 1e6;
+    }
+
+    std::printf("Users:       %zu (%.1f MB file)\n", opt.users, fileBytes / 1048576.0);
+    std::printf("Load:        %.1f ms (%.0f ns per user), index %.1f MB\n", loadMs, loadMs * 1e6 / std::max<size_t>(opt.users, 1),
+                store.Index().MemoryBytes() / 1048576.0);
+    PrintLatency("Login ok:", hitNs);
+    PrintLatency("Login fail:", missNs);
+    std::printf("Register:    %.0f ns each (%zu), flush %.2f ms\n", registerNs, opt.registrations, flushMs);
+    if (opt.scans) std::printf("Old scan:    %.1f ms per login (streaming the whole file)\n", scanMs / opt.scans);
+    std::printf("%s\n", ok ? "PASS: every login agrees with the file" : "FAIL");
+    if (!opt.keep) std::remove(opt.path.c_str());
+    return ok;
+}
+
+// ---------- KDF ----------
+struct KdfOptions {
+    KdfParams params;
+    size_t hashes = 20;         // timed one at a time, then through the pool
+    unsigned threads = std::thread::hardware_concurrency();
+    size_t queue = 0;           // pool bound; 0 = 2 per thread
+};
+
+// RFC 7914 sections 11 and 12.
+static bool KdfSelfTest() {
+    uint8_t out[64];
+    Pbkdf2Sha256("passwd", 6, "salt", 4, 1, out, 64);
+    bool ok = ToHex(out, 64) == "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+                                "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783";
+    KdfParams tiny;
+    tiny.logN = 4; tiny.r = 1; tiny.p = 1;
+    ok = ok && Scrypt("", 0, "", 0, tiny, out, 64) && ToHex(out, 64) ==
+        "77d6576238657b203b19ca42c18a0497f16b4844e3074ae8dfdffa3fede21442fcd0069ded0948f8326a753a0fc81f17e8d3e0fb2e0d3628cf35e20c38d18906";
+    KdfParams nacl;
+    nacl.logN = 10; nacl.r = 8; nacl.p = 16;
+    ok = ok && Scrypt("password", 8, "NaCl", 4, nacl, out, 64) && ToHex(out, 64) ==
+        "fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b3731622eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdfa2cc0640";
+    return ok;
+}
+
+static bool RunKdf(const KdfOptions& opt) {
+    const KdfParams& kp = opt.params;
+    if (!kp.Valid()) { std::fprintf(stderr, "cost out of range (at most 256 MB: 128 * r * 2^logN)\n"); return false; }
+    bool ok = KdfSelfTest();
+    std::printf("Self-test:   %s\n", ok ? "RFC 7914 vectors match" : "MISMATCH");
+
+    std::vector<double> ms;
+    std::string credential;
+    for (size_t i = 0; i < opt.hashes; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        credential = HashPassword("correct horse " + std::to_string(i), kp);
+        ms.push_back(NsSince(t0) / 1e6);
+    }
+    ok = ok && VerifyPassword("correct horse " + std::to_string(opt.hashes - 1), credential) &&
+         !VerifyPassword("correct horse", credential);
+    std::sort(ms.begin(), ms.end());
+    std::printf("Cost:        logN=%d r=%d p=%d, %.1f MB per hash\n", kp.logN, kp.r, kp.p, kp.MemoryBytes() / 1048576.0);
+    std::printf("Hash:        %zu, p50 %.1f ms, max %.1f ms\n", ms.size(), Percentile(ms, 50), ms.empty() ? 0.0 : ms.back());
+
+    // Verifications through the pool, submitting as fast as it accepts.
+    unsigned threads = std::max(1u, opt.threads);
+    size_t bound = opt.queue ? opt.queue : 2 * threads, peak = 0, refused = 0, matched = 0, done = 0;
+    AuthWorkers workers(threads, bound);
+    AuthJob job;
+    job.password = "correct horse " + std::to_string(opt.hashes - 1);
+    job.credential = credential;
+    job.params = kp;            // same cost as the stored hash, so nothing is rehashed
+    auto t0 = std::chrono::steady_clock::now();
+    AuthResult r;
+    for (size_t i = 0; i < opt.hashes;) {
+        if (workers.Submit(job)) { ++i; peak = std::max(peak, workers.Pending()); continue; }
+        refused++;
+        if (workers.Wait(r)) { done++; matched += r.ok && r.credential.empty(); }
+    }
+    while (workers.Wait(r)) { done++; matched += r.ok && r.credential.empty(); }
+    double secs = NsSince(t0) / 1e9;
+    ok = ok && matched == opt.hashes && done == opt.hashes && peak <= bound;
+    std::printf("Pool:        %u workers, at most %zu pending (peak %zu, %zu submits refused)\n", threads, bound, peak, refused);
+    std::printf("Throughput:  %.1f verifications/sec\n", secs > 0 ? done / secs : 0.0);
+    std::printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+// ---------- Table ----------
+struct TableOptions {
+    std::string path = "bench_users.db";
+    size_t users = 1000000;
+    bool keep = false;
+};
+
+static bool CopyFile(const std::string& from, const std::string& to) {
+    std::vector<char> buf;
+    if (!ReadWholeFile(from, buf)) return false;
+    FILE* f = std::fopen(to.c_str(), "wb");
+    bool ok = f && std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    if (f) ok = std::fclose(f) == 0 && ok;
+    return ok;
+}
+
+static bool RunTable(const TableOptions& opt) {
+    std::remove(opt.path.c_str());
+    std::mt19937_64 rng(0x7ab1e);
+    std::vector<std::string> names(opt.users);
+    for (size_t i = 0; i < opt.users; ++i) names[i] = UserName(rng, i);
+    // Same length as a real logN 14 credential, without paying for the KDF.
+    auto credential = [](size_t i, int version) {
+        char buf[160];
+        std::snprintf(buf, sizeof buf, "$scrypt$ln=14,r=8,p=1$%032zx$%064zx", i, i * 31 + (size_t)version);
+        return std::string(buf);
+    };
+    bool ok = true;
+    std::string got;
+
+    CredentialTable table;
+    if (!table.Open(opt.path)) { std::fprintf(stderr, "cannot create %s\n", opt.path.c_str()); return false; }
+    std::vector<uint32_t> insertNs(opt.users);
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < opt.users; ++i) {
+        auto q0 = std::chrono::steady_clock::now();
+        if (table.Insert(names[i], credential(i, 0)) != TableStatus::Ok) ok = false;
+        insertNs[i] = (uint32_t)std::min<double>(NsSince(q0), UINT32_MAX);
+    }
+    if (table.Insert(names[0], "again") != TableStatus::Exists) ok = false;
+    ok = ok && table.Sync();
+    double insertSecs = NsSince(t0) / 1e9;
+
+    // A copy taken while the table is open looks like a crash: its header
+    // still says "unclean", so opening it recounts.
+    std::string crashed = opt.path + ".crash";
+    double recountMs = 0;
+    if (CopyFile(opt.path, crashed)) {
+        CredentialTable copy;
+        t0 = std::chrono::steady_clock::now();
+        ok = ok && copy.Open(crashed) && copy.Size() == opt.users;
+        recountMs = NsSince(t0) / 1e6;
+        ok = ok && copy.Find(names[opt.users / 2], got) && got == credential(opt.users / 2, 0);
+    } else ok = false;
+    std::remove(crashed.c_str());
+
+    table.Close();
+    t0 = std::chrono::steady_clock::now();
+    ok = ok && table.Open(opt.path) && table.Size() == opt.users;
+    double openMs = NsSince(t0) / 1e6;
+
+    std::uniform_int_distribution<size_t> pick(0, opt.users - 1);
+    size_t lookups = std::min<size_t>(opt.users, 500000);
+    std::vector<uint32_t> findNs;
+    findNs.reserve(lookups);
+    for (size_t q = 0; q < lookups; ++q) {
+        size_t i = pick(rng);
+        bool miss = q & 1;
+        std::string name = miss ? "nobody" + std::to_string(q) : names[i];
+        auto q0 = std::chrono::steady_clock::now();
+        bool found = table.Find(name, got);
+        findNs.push_back((uint32_t)std::min<double>(NsSince(q0), UINT32_MAX));
+        if (found == miss || (found && got != credential(i, 0))) ok = false;
+    }
+
+    // Every tenth user changes password, every tenth (offset by five) leaves.
+    std::vector<uint32_t> updateNs, eraseNs;
+    for (size_t i = 0; i < opt.users; i += 10) {
+        auto q0 = std::chrono::steady_clock::now();
+        if (table.Update(names[i], credential(i, 1)) != TableStatus::Ok) ok = false;
+        updateNs.push_back((uint32_t)std::min<double>(NsSince(q0), UINT32_MAX));
+        if (i + 5 >= opt.users) continue;
+        q0 = std::chrono::steady_clock::now();
+        if (table.Erase(names[i + 5]) != TableStatus::Ok) ok = false;
+        eraseNs.push_back((uint32_t)std::min<double>(NsSince(q0), UINT32_MAX));
+    }
+    ok = ok && table.Sync();
+    size_t erased = eraseNs.size(), tombstones = table.Tombstones();
+    uint64_t bucketsBefore = table.Buckets();
+
+    t0 = std::chrono::steady_clock::now();
+    ok = ok && table.Compact();
+    double compactMs = NsSince(t0) / 1e6;
+    ok = ok && table.Size() == opt.users - erased && table.Tombstones() == 0;
+    for (size_t i = 0; ok && i < opt.users; i += 7) {
+        int version = i % 10 == 0 ? 1 : 0;
+        bool gone = i % 10 == 5;
+        bool found = table.Find(names[i], got);
+        if (found == gone || (found && got != credential(i, version))) ok = false;
+    }
+    table.Close();
+
+    std::printf("Users:       %zu, %llu buckets of %zu slots\n", opt.users, (unsigned long long)bucketsBefore, CredentialTable::SLOTS);
+    std::printf("Insert:      %.2f s total including growth rewrites\n", insertSecs);
+    PrintLatency("  latency:", insertNs);
+    std::printf("Open:        %.2f ms clean, %.1f ms after a crash (recount)\n", openMs, recountMs);
+    PrintLatency("Find:", findNs);
+    PrintLatency("Update:", updateNs);
+    PrintLatency("Erase:", eraseNs);
+    std::printf("Compact:     %.1f ms, %zu tombstones dropped\n", compactMs, tombstones);
+    std::printf("%s\n", ok ? "PASS: every answer agrees" : "FAIL");
+    if (!opt.keep) std::remove(opt.path.c_str());
+    return ok;
+}
+
+static bool RunImport(const std::string& textPath, const std::string& tablePath) {
+    CredentialTable table;
+    if (!table.Open(tablePath)) { std::fprintf(stderr, "cannot open %s\n", tablePath.c_str()); return false; }
+    auto t0 = std::chrono::steady_clock::now();
+    ImportResult r = ImportUsersText(textPath, table);
+    double ms = NsSince(t0) / 1e6;
+    if (!r.ok) { std::fprintf(stderr, "import from %s failed\n", textPath.c_str()); return false; }
+    std::printf("Imported %zu users in %.1f ms (%zu duplicates skipped, %zu too long); %zu in %s\n",
+                r.imported, ms, r.duplicates, r.tooLong, table.Size(), tablePath.c_str());
+    return true;
+}
+
+static bool RunCompact(const std::string& tablePath) {
+    CredentialTable table;
+    if (!table.Open(tablePath)) { std::fprintf(stderr, "cannot open %s\n", tablePath.c_str()); return false; }
+    size_t tombstones = table.Tombstones();
+    uint64_t buckets = table.Buckets();
+    auto t0 = std::chrono::steady_clock::now();
+    if (!table.Compact()) { std::fprintf(stderr, "compaction failed; %s is unchanged\n", tablePath.c_str()); return false; }
+    std::printf("Compacted %s in %.1f ms: %zu users, %zu tombstones dropped, %llu -> %llu buckets\n", tablePath.c_str(),
+                NsSince(t0) / 1e6, table.Size(), tombstones, (unsigned long long)buckets, (unsigned long long)table.Buckets());
+    return true;
+}
+
+// ---------- Limit ----------
+struct LimitOptions {
+    size_t ops = 2000000;       // attempts, split across the threads
+    size_t bots = 10000;        // attacking sources
+    size_t targets = 200000;    // usernames the attack sprays
+    size_t legit = 1000;        // real users, each on its own source
+    size_t capacity = 1 << 16;  // keys per tracker
+    size_t rate = 2000;         // attempts per simulated second
+    unsigned threads = std::thread::hardware_concurrency();
+};
+
+// The rules, step by step on a fake clock.
+static bool LimitSelfTest() {
+    LimitPolicy p;              // 3 free failures, 1 s backoff, 10 per 15 min window
+    AttemptTracker t(p, 16, 0);
+    bool ok = true;
+    for (int i = 0; i < 3; ++i) t.Record("a", false, 0);
+    ok = ok && t.Check("a", 0).allowed;
+    t.Record("a", false, 0);                                   // 4th: 1 s
+    LimitDecision d = t.Check("a", 999);
+    ok = ok && !d.allowed && d.reason == LimitReason::Backoff && d.retryAfterMs == 1 && t.Check("a", 1000).allowed;
+    t.Record("a", false, 1000);                                // 5th: 2 s
+    ok = ok && !t.Check("a", 2999).allowed && t.Check("a", 3000).allowed;
+    t.Record("a", true, 3000);
+    t.Record("a", false, 3000);                                // backoff starts over
+    ok = ok && t.Check("a", 3000).allowed;
+
+    for (int i = 0; i < 10; ++i) t.Record("b", false, i);
+    d = t.Check("b", 120000);
+    ok = ok && !d.allowed && d.reason == LimitReason::Lockout && d.retryAfterMs == p.lockoutMs + 9 - 120000;
+
+    // Nine failures two windows ago no longer count; nine a moment ago do.
+    for (int i = 0; i < 9; ++i) t.Record("c", false, 0);
+    t.Record("c", false, 2 * p.windowMs);
+    ok = ok && t.Check("c", 2 * p.windowMs + p.maxDelayMs).allowed;
+    for (int i = 0; i < 9; ++i) t.Record("d", false, 0);
+    t.Record("d", false, 1);
+    ok = ok && t.Check("d", p.maxDelayMs + 1).reason == LimitReason::Lockout;
+
+    // Unknown keys aren't stored; past capacity the oldest keys go.
+    t.Check("nobody", 0);
+    ok = ok && t.Stats().entries == 4;
+    // "c" is still backing off when it is pushed out, and is forgotten.
+    int64_t later = 2 * p.windowMs + 1000;
+    for (int i = 0; i < 100; ++i) t.Record("spray" + std::to_string(i), false, later);
+    LimiterStats st = t.Stats();
+    ok = ok && st.entries == 16 && st.evictions == 88 && st.evictedBlocked == 1 && t.Check("c", later).allowed;
+
+    // Registrations: a rate per source, whatever their outcome.
+    LoginLimiter both(64);
+    for (int i = 0; i < 99; ++i) both.RecordRegistration("host", i);
+    ok = ok && both.CheckRegistration("host", 100).allowed;
+    both.RecordRegistration("host", 100);
+    d = both.CheckRegistration("host", 101);
+    ok = ok && !d.allowed && d.reason == LimitReason::Lockout && both.CheckRegistration("other", 101).allowed;
+    return ok;
+}
+
+// A burst of wrong passwords for one name, all submitted before the first
+// is answered: only the attempts the limit allows may reach the hash pool.
+static bool ParallelLimitTest(size_t attempts, size_t& hashed) {
+    AuthConfig config;
+    config.dbPath = "bench_limit.db";
+    config.importPath = "";
+    config.params.logN = 10;
+    std::remove(config.dbPath.c_str());
+    AuthCore core(config);
+    core.Open();
+    bool ok = core.IsOpen();
+    for (size_t i = 0; ok && i < attempts; ++i) core.Submit(AuthRequest{AuthOp::Login, "victim", "guess" + std::to_string(i)}, "10.0.0.1", i);
+    size_t replies = 0;
+    hashed = 0;
+    for (AuthReply reply; ok && replies < attempts;) {
+        if (!core.Poll(reply)) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); continue; }
+        replies++;
+        hashed += reply.status == AuthStatus::Invalid;
+        ok = reply.status == AuthStatus::Invalid || reply.status == AuthStatus::Backoff || reply.status == AuthStatus::Locked;
+    }
+    core.Close();
+    std::remove(config.dbPath.c_str());
+    return ok && hashed > 0 && hashed <= (size_t)core.Limiter().users.Policy().lockoutFailures;
+}
+
+static bool RunLimit(const LimitOptions& opt) {
+    bool ok = LimitSelfTest();
+    std::printf("Self-test:   %s\n", ok ? "backoff, lockout, window and eviction rules hold" : "MISMATCH");
+    size_t hashed = 0;
+    bool parallel = ParallelLimitTest(200, hashed);
+    std::printf("Parallel:    %zu of 200 simultaneous wrong guesses hashed%s\n", hashed, parallel ? "" : " (MISMATCH)");
+    ok = ok && parallel;
+
+    std::mt19937_64 rng(0x1137);
+    std::vector<std::string> targets(opt.targets), bots(opt.bots), legit(opt.legit), legitSources(opt.legit);
+    for (size_t i = 0; i < opt.targets; ++i) targets[i] = UserName(rng, i);
+    for (size_t i = 0; i < opt.bots; ++i)
+        bots[i] = "10." + std::to_string(i >> 16 & 255) + "." + std::to_string(i >> 8 & 255) + "." + std::to_string(i & 255);
+    for (size_t i = 0; i < opt.legit; ++i) {
+        legit[i] = "legit" + std::to_string(i);
+        legitSources[i] = "192.168." + std::to_string(i >> 8 & 255) + "." + std::to_string(i & 255);
+    }
+
+    // 98% of attempts come from bots trying wrong passwords on random names;
+    // the rest are real users, who get their password right 95% of the time.
+    LoginLimiter limiter(opt.capacity);
+    unsigned threads = std::max(1u, opt.threads);
+    std::atomic<size_t> next{0}, attacks{0}, attacksAllowed{0}, logins{0}, loginsAllowed{0};
+    std::vector<std::vector<uint32_t>> ns(threads);
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned w = 0; w < threads; ++w) {
+        pool.emplace_back([&, w] {
+            std::mt19937_64 r(0x5eed + w);
+            size_t attack = 0, attackOk = 0, login = 0, loginOk = 0;
+            ns[w].reserve(opt.ops / threads + 1);
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < opt.ops;) {
+                int64_t now = (int64_t)(i * 1000 / opt.rate);
+                uint64_t x = r();
+                bool bot = x % 100 < 98;
+                const std::string& user = bot ? targets[(x >> 8) % opt.targets] : legit[(x >> 8) % opt.legit];
+                const std::string& source = bot ? bots[(x >> 32) % opt.bots] : legitSources[(x >> 8) % opt.legit];
+                bool success = !bot && (x >> 40) % 100 < 95;
+                auto q0 = std::chrono::steady_clock::now();
+                bool allowed = limiter.Check(user, source, now).allowed;
+                if (allowed) limiter.Record(user, source, success, now);
+                ns[w].push_back((uint32_t)std::min<double>(NsSince(q0), UINT32_MAX));
+                if (bot) { attack++; attackOk += allowed; } else { login++; loginOk += allowed; }
+            }
+            attacks += attack; attacksAllowed += attackOk; logins += login; loginsAllowed += loginOk;
+        });
+    }
+    for (auto& t : pool) t.join();
+    double secs = NsSince(t0) / 1e9;
+
+    std::vector<uint32_t> all;
+    all.reserve(opt.ops);
+    for (auto& v : ns) all.insert(all.end(), v.begin(), v.end());
+    LimiterStats u = limiter.users.Stats(), s = limiter.sources.Stats();
+    ok = ok && u.entries <= u.capacity && s.entries <= s.capacity && u.checks == opt.ops && s.checks == opt.ops;
+
+    std::printf("Attack:      %zu attempts over %.0f simulated s, %zu bots, %zu target names, %zu real users\n",
+                opt.ops, opt.ops / (double)opt.rate, opt.bots, opt.targets, opt.legit);
+    std::printf("Throughput:  %.2f M checks/sec on %u threads (check plus record)\n", secs > 0 ? opt.ops / secs / 1e6 : 0.0, threads);
+    PrintLatency("Check:", all);
+    std::printf("Allowed:     %.2f%% of bot attempts, %.2f%% of real logins\n",
+                100.0 * attacksAllowed / std::max<size_t>(attacks, 1), 100.0 * loginsAllowed / std::max<size_t>(logins, 1));
+    std::printf("Usernames:   %zu of %zu slots, %llu evicted (%llu while blocked), %.1f MB\n", u.entries, u.capacity,
+                (unsigned long long)u.evictions, (unsigned long long)u.evictedBlocked, u.memoryBytes / 1048576.0);
+    std::printf("Sources:     %zu of %zu slots, %llu evicted (%llu while blocked), %.1f MB\n", s.entries, s.capacity,
+                (unsigned long long)s.evictions, (unsigned long long)s.evictedBlocked, s.memoryBytes / 1048576.0);
+    std::printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+// ---------- Load ----------
+struct LoadOptions {
+    ServiceAddress addr;
+    bool external = false;      // --socket or --port: drive a running login_service
+    unsigned concurrency = 16;  // clients, each with one request in flight
+    double seconds = 5;
+    size_t users = 64;          // registered first, then logged into at random
+    AuthConfig config;          // for the service started in-process
+};
+
+static bool RunLoad(LoadOptions opt) {
+#ifdef __linux__
+    // Without an address, serve a scratch table from a thread of this process
+    std::unique_ptr<AuthCore> core;
+    std::unique_ptr<AuthServer> server;
+    std::thread serving;
+    if (!opt.external) {
+        opt.addr.socketPath = "bench_service.sock";
+        opt.config.dbPath = "bench_service.db";
+        opt.config.importPath = "";
+        std::remove(opt.config.dbPath.c_str());
+        core.reset(new AuthCore(opt.config));
+        server.reset(new AuthServer(*core));
+        core->Open();
+        if (!core->IsOpen() || !server->Listen(opt.addr)) {
+            std::fprintf(stderr, "cannot serve %s on %s\n", opt.config.dbPath.c_str(), opt.addr.socketPath.c_str());
+            return false;
+        }
+        serving = std::thread([&] { server->Run(); });
+    }
+#else
+    if (!opt.external) { std::fprintf(stderr, "the in-process service needs Linux; pass --socket or --port\n"); return false; }
+#endif
+    unsigned clients = std::max(1u, opt.concurrency);
+    auto forEachClient = [&](auto body) {
+        std::vector<std::thread> pool;
+        for (unsigned c = 0; c < clients; ++c) pool.emplace_back(body, c);
+        for (auto& t : pool) t.join();
+    };
+    auto userName = [](size_t i) { return "load" + std::to_string(i); };
+    auto password = [](size_t i) { return "pw-" + std::to_string(i * 7919); };
+
+    // Register (or find already registered) every user.
+    std::atomic<size_t> registered{0}, failures{0};
+    auto t0 = std::chrono::steady_clock::now();
+    forEachClient([&](unsigned c) {
+        AuthClient client;
+        if (!client.Connect(opt.addr)) { failures++; return; }
+        for (size_t i = c; i < opt.users; i += clients) {
+            AuthRequest req{AuthOp::Register, userName(i), password(i)};
+            AuthReply reply;
+            if (client.Call(req, reply) && (reply.status == AuthStatus::Ok || reply.status == AuthStatus::Exists)) registered++;
+            else failures++;
+        }
+    });
+    double registerSecs = NsSince(t0) / 1e9;
+
+    // Closed loop: each client sends its next login as soon as the last returns.
+    std::vector<std::vector<double>> ms(clients);
+    std::vector<std::array<size_t, (int)AuthStatus::Bad + 1>> statuses(clients);
+    t0 = std::chrono::steady_clock::now();
+    auto deadline = t0 + std::chrono::microseconds((int64_t)(opt.seconds * 1e6));
+    forEachClient([&](unsigned c) {
+        AuthClient client;
+        statuses[c].fill(0);
+        if (!client.Connect(opt.addr)) { failures++; return; }
+        std::mt19937_64 rng(0x10ad + c);
+        while (std::chrono::steady_clock::now() < deadline) {
+            size_t i = rng() % opt.users;
+            AuthRequest req{AuthOp::Login, userName(i), password(i)};
+            AuthReply reply;
+            auto q0 = std::chrono::steady_clock::now();
+            if (!client.Call(req, reply)) { failures++; return; }
+            ms[c].push_back(NsSince(q0) / 1e6);
+            statuses[c][(int)reply.status]++;
+        }
+    });
+    double secs = NsSince(t0) / 1e9;
+
+#ifdef __linux__
+    if (server) {
+        server->Stop();
+        serving.join();
+        server.reset();
+        core.reset();
+        std::remove(opt.config.dbPath.c_str());
+    }
+#endif
+    std::vector<double> all;
+    for (auto& v : ms) all.insert(all.end(), v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    size_t counts[(int)AuthStatus::Bad + 1] = {};
+    for (auto& s : statuses)
+        for (int k = 0; k <= (int)AuthStatus::Bad; ++k) counts[k] += s[k];
+    bool ok = failures == 0 && registered == opt.users && counts[(int)AuthStatus::Ok] == all.size() && !all.empty();
+
+    const KdfParams& kp = opt.config.params;
+    if (opt.external) std::printf("Service:     %s\n", opt.addr.ToString().c_str());
+    else std::printf("Service:     in-process on %s, %u hashing threads, logN=%d r=%d p=%d\n", opt.addr.socketPath.c_str(),
+                     opt.config.threads, kp.logN, kp.r, kp.p);
+    std::printf("Register:    %zu users in %.2f s\n", (size_t)registered, registerSecs);
+    std::printf("Logins:      %zu from %u clients in %.2f s: %.1f logins/sec\n", all.size(), clients, secs,
+                secs > 0 ? all.size() / secs : 0.0);
+    std::printf("Latency:     p50 %.1f ms, p99 %.1f ms, max %.1f ms\n", Percentile(all, 50), Percentile(all, 99),
+                all.empty() ? 0.0 : all.back());
+    std::printf("Replies:    ");
+    for (int k = 0; k <= (int)AuthStatus::Bad; ++k)
+        if (counts[k]) std::printf(" %s %zu", AuthStatusName((AuthStatus)k), counts[k]);
+    std::printf("%s\n", failures ? (", " + std::to_string(failures) + " connection failures").c_str() : "");
+    std::printf("%s\n", ok ? "PASS: every login succeeded" : "FAIL");
+    return ok;
+}
+
+// ---------- Driver ----------
+static void PrintUsage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s bench [--users n] [--lookups n] [--registrations n] [--scans n] [--file path] [--keep 1]\n"
+        "       %s kdf [--logn n] [--r n] [--p n] [--hashes n] [-j threads] [--queue n]\n"
+        "       %s table [--users n] [--file path] [--keep 1]\n"
+        "       %s import users.txt users.db\n"
+        "       %s compact users.db\n"
+        "       %s load [--socket path | --port n] [-c clients] [--seconds s] [--users n] [-j threads] [--logn n]\n"
+        "       %s limit [--ops n] [--bots n] [--targets n] [--legit n] [--capacity n] [--rate n] [-j threads]\n"
+        "  bench  generates <path> (default bench_users.txt) with n users and times\n"
+        "         loading, logins and registrations. Exits with 3 on a wrong answer.\n"
+        "  kdf    scrypt self-test, time per hash at the given cost (default logN 14,\n"
+        "         r 8, p 1) and pool throughput. Exits with 3 on a wrong answer.\n"
+        "  table  times the on-disk credential table (default bench_users.db).\n"
+        "         Exits with 3 on a wrong answer.\n"
+        "  limit  attempt limiter self-test and cost per check under a simulated\n"
+        "         attack. Exits with 3 on a wrong answer.\n"
+        "  load   registers n users and logs in from c clients for s seconds, against\n"
+        "         a running login_service or, without an address, one started in this\n"
+        "         process (-j, --logn). Exits with 3 if a login fails.\n",
+        argv0, argv0, argv0, argv0, argv0, argv0, argv0);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { PrintUsage(argv[0]); return 2; }
+    std::string cmd = argv[1];
+    if (cmd == "bench") {
+        BenchOptions opt;
+        for (int i = 2; i < argc; ++i) {
+            std::string a = argv[i];
+            const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!v) { PrintUsage(argv[0]); return 2; }
+            if (a == "--users") opt.users = (size_t)std::atol(v);
+            else if (a == "--lookups") opt.lookups = (size_t)std::atol(v);
+            else if (a == "--registrations") opt.registrations = (size_t)std::atol(v);
+            else if (a == "--scans") opt.scans = (size_t)std::atol(v);
+            else if (a == "--file") opt.path = v;
+            else if (a == "--keep") opt.keep = std::atoi(v) != 0;
+            else { PrintUsage(argv[0]); return 2; }
+            ++i;
+        }
+        if (opt.users < 1) opt.users = 1;
+        return RunBench(opt) ? 0 : 3;
+    }
+    if (cmd == "kdf") {
+        KdfOptions opt;
+        for (int i = 2; i < argc; ++i) {
+            std::string a = argv[i];
+            const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!v) { PrintUsage(argv[0]); return 2; }
+            if (a == "--logn") opt.params.logN = std::atoi(v);
+            else if (a == "--r") opt.params.r = std::atoi(v);
+            else if (a == "--p") opt.params.p = std::atoi(v);
+            else if (a == "--hashes") opt.hashes = (size_t)std::atol(v);
+            else if (a == "-j") opt.threads = (unsigned)std::atoi(v);
+            else if (a == "--queue") opt.queue = (size_t)std::atol(v);
+            else { PrintUsage(argv[0]); return 2; }
+            ++i;
+        }
+        if (opt.hashes < 1) opt.hashes = 1;
+        return RunKdf(opt) ? 0 : 3;
+    }
+    if (cmd == "table") {
+        TableOptions opt;
+        for (int i = 2; i < argc; ++i) {
+            std::string a = argv[i];
+            const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!v) { PrintUsage(argv[0]); return 2; }
+            if (a == "--users") opt.users = (size_t)std::atol(v);
+            else if (a == "--file") opt.path = v;
+            else if (a == "--keep") opt.keep = std::atoi(v) != 0;
+            else { PrintUsage(argv[0]); return 2; }
+            ++i;
+        }
+        if (opt.users < 10) opt.users = 10;
+        return RunTable(opt) ? 0 : 3;
+    }
+    if (cmd == "limit") {
+        LimitOptions opt;
+        for (int i = 2; i < argc; ++i) {
+            std::string a = argv[i];
+            const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!v) { PrintUsage(argv[0]); return 2; }
+            if (a == "--ops") opt.ops = (size_t)std::atol(v);
+            else if (a == "--bots") opt.bots = (size_t)std::atol(v);
+            else if (a == "--targets") opt.targets = (size_t)std::atol(v);
+            else if (a == "--legit") opt.legit = (size_t)std::atol(v);
+            else if (a == "--capacity") opt.capacity = (size_t)std::atol(v);
+            else if (a == "--rate") opt.rate = (size_t)std::atol(v);
+            else if (a == "-j") opt.threads = (unsigned)std::atoi(v);
+            else { PrintUsage(argv[0]); return 2; }
+            ++i;
+        }
+        opt.bots = std::max<size_t>(opt.bots, 1);
+        opt.targets = std::max<size_t>(opt.targets, 1);
+        opt.legit = std::max<size_t>(opt.legit, 1);
+        opt.rate = std::max<size_t>(opt.rate, 1);
+        return RunLimit(opt) ? 0 : 3;
+    }
+    if (cmd == "load") {
+        LoadOptions opt;
+        opt.config.threads = std::max(1u, std::thread::hardware_concurrency());
+        for (int i = 2; i < argc; ++i) {
+            std::string a = argv[i];
+            const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!v) { PrintUsage(argv[0]); return 2; }
+            if (a == "--socket") { opt.addr.socketPath = v; opt.external = true; }
+            else if (a == "--port") { opt.addr.port = std::atoi(v); opt.external = true; }
+            else if (a == "-c") opt.concurrency = (unsigned)std::atoi(v);
+            else if (a == "--seconds") opt.seconds = std::atof(v);
+            else if (a == "--users") opt.users = (size_t)std::atol(v);
+            else if (a == "-j") opt.config.threads = (unsigned)std::atoi(v);
+            else if (a == "--logn") opt.config.params.logN = std::atoi(v);
+            else { PrintUsage(argv[0]); return 2; }
+            ++i;
+        }
+        if (opt.users < 1) opt.users = 1;
+        if (!opt.config.params.Valid()) { std::fprintf(stderr, "cost out of range\n"); return 2; }
+        return RunLoad(opt) ? 0 : 3;
+    }
+    if (cmd == "import" && argc == 4) return RunImport(argv[2], argv[3]) ? 0 : 1;
+    if (cmd == "compact" && argc == 3) return RunCompact(argv[2]) ? 0 : 1;
+    PrintUsage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,168 @@
+// Password hashing off the UI thread: a fixed pool of workers runs the slow
+// KDF work (LoginHash.h) and hands results back through a queue the raylib
+// loop polls once per frame. The pool size bounds how many hashes run at
+// once (each holds KdfParams::MemoryBytes() of scratch) and `maxPending`
+// bounds how many can wait. No raylib dependency.
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LoginHash.h"
+
+// ---------- Jobs ----------
+enum class AuthJobKind { Hash, Verify };
+
+struct AuthJob {
+    AuthJobKind kind = AuthJobKind::Verify;
+    std::string username;
+    std::string password;
+    std::string credential;     // Verify: the stored credential; empty if the user doesn't exist
+    KdfParams params;           // cost of new hashes (Hash, and Verify's rehash)
+};
+
+struct AuthResult {
+    uint64_t ticket = 0;
+    AuthJobKind kind = AuthJobKind::Verify;
+    std::string username;
+    bool ok = false;            // Hash: a credential was produced; Verify: the password matched
+    std::string credential;     // Hash: the new credential; Verify: a replacement
+                                // when the stored one is plain text or used other params
+    double ms = 0;              // time spent hashing
+};
+
+// ---------- Auth Workers ----------
+class AuthWorkers {
+public:
+    explicit AuthWorkers(unsigned threads = 2, size_t maxPending = 16) : maxPending(maxPending) {
+        if (threads == 0) threads = 1;
+        for (unsigned i = 0; i < threads; ++i) pool.emplace_back([this] { Run(); });
+    }
+    ~AuthWorkers() { Stop(); }
+
+    AuthWorkers(const AuthWorkers&) = delete;
+    AuthWorkers& operator=(const AuthWorkers&) = delete;
+
+    // Called on the worker thread after each result is queued, so an event
+    // loop can wake up and Poll(); set it before the first Submit().
+    void OnResult(std::function<void()> fn) { onResult = std::move(fn); }
+
+    // Queues a job and returns its ticket, or 0 if `maxPending` jobs are
+    // already queued or running.
+    uint64_t Submit(AuthJob job) {
+        std::lock_guard<std::mutex> lk(m);
+        if (stopping || inFlight >= maxPending) return 0;
+        jobs.push_back(Queued{++lastTicket, std::move(job)});
+        inFlight++;
+        cv.notify_one();
+        return lastTicket;
+    }
+
+    // Takes a finished result without blocking; for the UI loop.
+    bool Poll(AuthResult& out) {
+        std::lock_guard<std::mutex> lk(m);
+        return TakeResult(out);
+    }
+
+    // Blocks until a result is ready; false if nothing is queued or running.
+    bool Wait(AuthResult& out) {
+        std::unique_lock<std::mutex> lk(m);
+        finished.wait(lk, [this] { return !results.empty() || inFlight == 0; });
+        return TakeResult(out);
+    }
+
+    size_t Pending() {
+        std::lock_guard<std::mutex> lk(m);
+        return inFlight;
+    }
+
+    // Drops queued jobs, lets running ones finish and joins the workers.
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            stopping = true;
+            inFlight -= jobs.size();
+            jobs.clear();
+        }
+        cv.notify_all();
+        for (auto& t : pool) t.join();
+        pool.clear();
+    }
+
+private:
+    struct Queued {
+        uint64_t ticket;
+        AuthJob job;
+    };
+
+    bool TakeResult(AuthResult& out) {
+        if (results.empty()) return false;
+        out = std::move(results.front());
+        results.pop_front();
+        return true;
+    }
+
+    static AuthResult Execute(const Queued& q) {
+        AuthResult r;
+        r.ticket = q.ticket;
+        r.kind = q.job.kind;
+        r.username = q.job.username;
+        auto t0 = std::chrono::steady_clock::now();
+        if (q.job.kind == AuthJobKind::Hash) {
+            r.credential = HashPassword(q.job.password, q.job.params);
+            r.ok = !r.credential.empty();
+        } else if (!q.job.credential.empty()) {
+            ParsedCredential parsed;
+            bool plain = !IsHashedCredential(q.job.credential) || !ParseCredential(q.job.credential, parsed);
+            r.ok = VerifyPassword(q.job.password, q.job.credential);
+            if (r.ok && NeedsRehash(q.job.credential, q.job.params)) r.credential = HashPassword(q.job.password, q.job.params);
+            // Comparing plain text takes no time; hash anyway, as a match
+            // (rehashed) or an unknown user would, so a wrong guess doesn't
+            // reveal that the name exists.
+            else if (plain) HashPassword(q.job.password, q.job.params);
+        } else {
+            // Unknown user: spend the same time as a real check so the reply
+            // doesn't reveal which names exist.
+            HashPassword(q.job.password, q.job.params);
+        }
+        r.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        return r;
+    }
+
+    void Run() {
+        for (;;) {
+            Queued q;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                cv.wait(lk, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+                q = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            AuthResult r = Execute(q);
+            {
+                std::lock_guard<std::mutex> lk(m);
+                results.push_back(std::move(r));
+                inFlight--;
+            }
+            finished.notify_all();
+            if (onResult) onResult();
+        }
+    }
+
+    const size_t maxPending;
+    std::function<void()> onResult;
+    std::vector<std::thread> pool;
+    std::mutex m;
+    std::condition_variable cv, finished;
+    std::deque<Queued> jobs;
+    std::deque<AuthResult> results;
+    size_t inFlight = 0;        // queued or running; results not yet taken don't count
+    uint64_t lastTicket = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,228 @@
+// Headless batch solver: streams puzzles (one per line, ParsePuzzle format),
+// solves them on all cores and writes solutions in input order.
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SudokuCore.h"
+#include "SudokuValidate.h"
+
+// ------------------- Work-Stealing Pool -------------------
+// Each worker owns a slice of the index range and takes small chunks from
+// its front. When its slice runs dry it steals the back half of another
+// worker's slice, so hard puzzles clustered in one region don't leave the
+// other cores idle. The calling thread participates as worker 0.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned count) : slices(count ? count : 1) {
+        for (unsigned i=1;i<slices.size();i++) threads.emplace_back([this,i]{ WorkerLoop(i); });
+    }
+
+    ~WorkStealingPool() {
+        { std::lock_guard<std::mutex> lk(m); stopping=true; }
+        wake.notify_all();
+        for (auto &t: threads) t.join();
+    }
+
+    unsigned Size() const { return (unsigned)slices.size(); }
+
+    // Calls fn(i) for every i in [0,count) and returns once all calls are done.
+    void ParallelFor(size_t count, const std::function<void(size_t)> &fn) {
+        size_t per=(count+slices.size()-1)/slices.size();
+        for (size_t w=0;w<slices.size();w++) {
+            std::lock_guard<std::mutex> lk(slices[w].m);
+            slices[w].begin=std::min(count,w*per);
+            slices[w].end=std::min(count,(w+1)*per);
+        }
+        {
+            std::lock_guard<std::mutex> lk(m);
+            job=&fn; busy=(unsigned)slices.size()-1; generation++;
+        }
+        wake.notify_all();
+        RunShare(0);
+        std::unique_lock<std::mutex> lk(m);
+        idle.wait(lk,[this]{ return busy==0; });
+        job=nullptr;
+    }
+
+private:
+    static constexpr size_t GRAIN = 16;
+
+    struct alignas(64) Slice { std::mutex m; size_t begin=0, end=0; };
+
+    bool Take(unsigned self, size_t &b, size_t &e) {
+        Slice &own=slices[self];
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lk(own.m);
+                if (own.begin<own.end) {
+                    b=own.begin; e=std::min(own.end,b+GRAIN); own.begin=e;
+                    return true;
+                }
+            }
+            size_t sb=0, se=0;
+            for (size_t k=1;k<slices.size() && sb==se;k++) {
+                Slice &victim=slices[(self+k)%slices.size()];
+                std::lock_guard<std::mutex> lk(victim.m);
+                size_t left=victim.end-victim.begin;
+                if (left==0) continue;
+                se=victim.end; sb=se-(left+1)/2; victim.end=sb;
+            }
+            if (sb==se) return false;
+            std::lock_guard<std::mutex> lk(own.m);
+            own.begin=sb; own.end=se;
+        }
+    }
+
+    void RunShare(unsigned self) {
+        const std::function<void(size_t)> &fn=*job;
+        size_t b, e;
+        while (Take(self,b,e))
+            for (size_t i=b;i<e;i++) fn(i);
+    }
+
+    void WorkerLoop(unsigned self) {
+        unsigned long seen=0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(m);
+                wake.wait(lk,[&]{ return stopping || generation!=seen; });
+                if (stopping) return;
+                seen=generation;
+            }
+            RunShare(self);
+            std::lock_guard<std::mutex> lk(m);
+            if (--busy==0) idle.notify_one();
+        }
+    }
+
+    std::vector<Slice> slices;
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable wake, idle;
+    const std::function<void(size_t)> *job=nullptr;
+    unsigned long generation=0;
+    unsigned busy=0;
+    bool stopping=false;
+};
+
+// ------------------- Batch Driver -------------------
+struct BatchOptions {
+    std::string input, output="-", timesPath;
+    unsigned threads=std::thread::hardware_concurrency();
+    size_t blockSize=1<<16;
+    bool checkOnly=false;   // validate already-solved grids instead of solving
+};
+
+static void PrintUsage(const char *argv0) {
+    std::fprintf(stderr,
+        "Usage: %s <puzzles.txt> [-o solutions.txt] [-j threads] [--times times.csv] [--block n] [--check]\n"
+        "  Reads one puzzle per line (81 cells, '1'-'9' givens, anything else empty).\n"
+        "  Writes one line per puzzle in input order: the 81-digit solution or 'unsolvable'.\n"
+        "  --times writes 'index,micros,solved' per puzzle.\n"
+        "  --check validates completed grids instead, writing 'valid' or 'invalid' per line.\n",argv0);
+}
+
+static bool ParseArgs(int argc, char **argv, BatchOptions &opt) {
+    for (int i=1;i<argc;i++) {
+        std::string a=argv[i];
+        auto next=[&]()->const char* { return i+1<argc ? argv[++i] : nullptr; };
+        const char *v=nullptr;
+        if (a=="-o") { if (!(v=next())) return false; opt.output=v; }
+        else if (a=="-j") { if (!(v=next())) return false; opt.threads=(unsigned)std::atoi(v); }
+        else if (a=="--times") { if (!(v=next())) return false; opt.timesPath=v; }
+        else if (a=="--block") { if (!(v=next())) return false; opt.blockSize=(size_t)std::atol(v); }
+        else if (a=="--check") opt.checkOnly=true;
+        else if (a=="-h"||a=="--help") return false;
+        else if (opt.input.empty()) opt.input=a;
+        else return false;
+    }
+    if (opt.threads==0) opt.threads=1;
+    if (opt.blockSize==0) opt.blockSize=1;
+    return !opt.input.empty();
+}
+
+static bool IsPuzzleLine(const std::string &line) {
+    for (char ch: line) {
+        if (ch==' '||ch=='\t'||ch=='\r') continue;
+        return ch!='#';
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    BatchOptions opt;
+    if (!ParseArgs(argc,argv,opt)) { PrintUsage(argv[0]); return 2; }
+
+    std::ifstream in(opt.input);
+    if (!in) { std::fprintf(stderr,"Cannot open %s\n",opt.input.c_str()); return 1; }
+    std::ofstream outFile;
+    if (opt.output!="-") {
+        outFile.open(opt.output);
+        if (!outFile) { std::fprintf(stderr,"Cannot write %s\n",opt.output.c_str()); return 1; }
+    }
+    std::ostream &out=opt.output=="-" ? std::cout : outFile;
+    std::ofstream times;
+    if (!opt.timesPath.empty()) {
+        times.open(opt.timesPath);
+        if (!times) { std::fprintf(stderr,"Cannot write %s\n",opt.timesPath.c_str()); return 1; }
+        times<<"index,micros,solved\n";
+    }
+
+    WorkStealingPool pool(opt.threads);
+    std::vector<Grid> grids;
+    std::vector<float> micros;
+    std::vector<uint8_t> solved;
+    grids.reserve(opt.blockSize); micros.resize(opt.blockSize); solved.resize(opt.blockSize);
+
+    size_t total=0, solvedCount=0;
+    double sumMicros=0, maxMicros=0;
+    auto wallStart=std::chrono::steady_clock::now();
+    std::string line;
+    bool more=true;
+    while (more) {
+        grids.clear();
+        while (grids.size()<opt.blockSize && (more=(bool)std::getline(in,line)))
+            if (IsPuzzleLine(line)) grids.push_back(ParsePuzzle(line));
+        if (grids.empty()) break;
+
+        pool.ParallelFor(grids.size(),[&](size_t i) {
+            auto t0=std::chrono::steady_clock::now();
+            if (opt.checkOnly) solved[i]=ComputeConflicts(grids[i]).Solved();
+            else {
+                Grid puzzle=grids[i];
+                solved[i]=SolveSudoku(grids[i]) && IsValidSolution(puzzle,grids[i]);
+            }
+            micros[i]=std::chrono::duration<float,std::micro>(std::chrono::steady_clock::now()-t0).count();
+        });
+
+        for (size_t i=0;i<grids.size();i++) {
+            if (opt.checkOnly) out<<(solved[i] ? "valid\n" : "invalid\n");
+            else if (solved[i]) out<<FormatGrid(grids[i])<<'\n';
+            else out<<"unsolvable\n";
+            solvedCount+=solved[i];
+            if (times.is_open()) times<<(total+i)<<','<<micros[i]<<','<<int(solved[i])<<'\n';
+            sumMicros+=micros[i];
+            if (micros[i]>maxMicros) maxMicros=micros[i];
+        }
+        total+=grids.size();
+    }
+    out.flush();
+    double wall=std::chrono::duration<double>(std::chrono::steady_clock::now()-wallStart).count();
+
+    if (opt.checkOnly) std::fprintf(stderr,"Grids:      %zu (%zu valid, %zu invalid)\n",total,solvedCount,total-solvedCount);
+    else std::fprintf(stderr,"Puzzles:    %zu (%zu solved, %zu unsolvable)\n",total,solvedCount,total-solvedCount);
+    std::fprintf(stderr,"Threads:    %u\n",pool.Size());
+    std::fprintf(stderr,"Wall time:  %.3f s\n",wall);
+    std::fprintf(stderr,"Throughput: %.0f puzzles/sec\n",wall>0 ? total/wall : 0.0);
+    if (total) std::fprintf(stderr,"%s mean %.1f us, max %.1f us\n",opt.checkOnly ? "Check time:" : "Solve time:",sumMicros/total,maxMicros);
+    return solvedCount==total ? 0 : 3;
+}
@@ -0,0 +1,279 @@
+// Solver benchmark: times SolveSudoku over bundled puzzle corpora and over
+// generated 16x16 and 25x25 boards, and reports latency percentiles, search
+// nodes and throughput, optionally as JSON and against a previous run's JSON
+// for regression checks.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "SudokuCore.h"
+#include "SudokuGenerator.h"
+#include "SudokuValidate.h"
+
+// ------------------- Corpus -------------------
+struct Corpus {
+    std::string name, path;
+    std::vector<Grid> puzzles;
+};
+
+static bool IsPuzzleLine(const std::string &line) {
+    for (char ch: line) {
+        if (ch==' '||ch=='\t'||ch=='\r') continue;
+        return ch!='#';
+    }
+    return false;
+}
+
+// Name is the file stem: puzzles/17clue.txt -> "17clue".
+static std::string CorpusName(const std::string &path) {
+    size_t slash=path.find_last_of("/\\");
+    std::string stem=slash==std::string::npos ? path : path.substr(slash+1);
+    size_t dot=stem.find_last_of('.');
+    return dot==std::string::npos ? stem : stem.substr(0,dot);
+}
+
+static bool LoadCorpus(const std::string &path, Corpus &out) {
+    std::ifstream in(path);
+    if (!in) return false;
+    out.name=CorpusName(path); out.path=path; out.puzzles.clear();
+    std::string line;
+    while (std::getline(in,line))
+        if (IsPuzzleLine(line)) out.puzzles.push_back(ParsePuzzle(line));
+    return true;
+}
+
+// ------------------- Measurement -------------------
+struct CorpusStats {
+    size_t count=0, solved=0;
+    double medianUs=0, p99Us=0, maxUs=0, meanUs=0, totalUs=0;
+    uint64_t nodesTotal=0, nodesMedian=0, nodesMax=0;
+    size_t worstIndex=0;
+
+    double PuzzlesPerSec() const { return totalUs>0 ? count*1e6/totalUs : 0.0; }
+};
+
+// Nearest-rank percentile of an ascending vector.
+template <typename T>
+static T Percentile(const std::vector<T> &sorted, double p) {
+    if (sorted.empty()) return T{};
+    size_t rank=(size_t)std::ceil(p/100.0*sorted.size());
+    return sorted[std::min(sorted.size(),std::max<size_t>(rank,1))-1];
+}
+
+// Each puzzle is timed `repeat` times and its fastest run kept, which
+// filters out scheduler noise. Nodes come from one extra instrumented run so
+// the atomic counters don't skew the timings.
+template <int B>
+static CorpusStats RunPuzzles(const std::vector<GridT<B>> &puzzles, int repeat) {
+    CorpusStats st;
+    st.count=puzzles.size();
+    std::vector<double> times(st.count);
+    std::vector<uint64_t> nodes(st.count);
+    for (size_t i=0;i<st.count;i++) {
+        const GridT<B> &puzzle=puzzles[i];
+        double best=0;
+        bool ok=false;
+        for (int k=0;k<repeat;k++) {
+            GridT<B> g=puzzle;
+            auto t0=std::chrono::steady_clock::now();
+            bool solved=SolveSudoku<B>(g);
+            double us=std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now()-t0).count();
+            if (k==0 || us<best) best=us;
+            ok=k==0 ? solved && IsValidSolution<B>(puzzle,g) : ok && solved;
+        }
+        SolveControl control;
+        GridT<B> g=puzzle;
+        SolveSudoku<B>(g,&control);
+        times[i]=best; nodes[i]=control.nodes.load();
+        st.solved+=ok;
+        st.totalUs+=best;
+        st.nodesTotal+=nodes[i];
+        if (best>st.maxUs) { st.maxUs=best; st.worstIndex=i; }
+    }
+    if (st.count) st.meanUs=st.totalUs/st.count;
+    std::sort(times.begin(),times.end());
+    std::sort(nodes.begin(),nodes.end());
+    st.medianUs=Percentile(times,50); st.p99Us=Percentile(times,99);
+    st.nodesMedian=Percentile(nodes,50); st.nodesMax=nodes.empty() ? 0 : nodes.back();
+    return st;
+}
+
+// The boards the GUI deals for the larger sizes, from a fixed seed so runs
+// compare. `genMaxUs` receives the slowest generation.
+template <int B>
+static std::vector<GridT<B>> GenerateBoards(int count, double &genMaxUs) {
+    std::mt19937 rng(12345);
+    std::vector<GridT<B>> boards;
+    genMaxUs=0;
+    for (int i=0;i<count;i++) {
+        auto t0=std::chrono::steady_clock::now();
+        boards.push_back(GenerateQuickPuzzle<B>(B*B*B*B*45/100,rng));
+        genMaxUs=std::max(genMaxUs,std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now()-t0).count());
+    }
+    return boards;
+}
+
+// ------------------- Reporting -------------------
+static std::string JsonEscape(const std::string &s) {
+    std::string out;
+    for (char ch: s) {
+        if (ch=='"'||ch=='\\') out+='\\';
+        out+=ch;
+    }
+    return out;
+}
+
+static void WriteJson(FILE *f, const std::vector<std::string> &names, const std::vector<CorpusStats> &stats, int repeat) {
+    std::fprintf(f,"{\n  \"solver\": \"BitSolver\",\n  \"grid_bytes\": %zu,\n  \"solver_bytes\": %zu,\n  \"repeat\": %d,\n",
+        sizeof(Grid),sizeof(BitSolver),repeat);
+#if defined(__VERSION__)
+    std::fprintf(f,"  \"compiler\": \"%s\",\n",JsonEscape(__VERSION__).c_str());
+#endif
+    std::fprintf(f,"  \"corpora\": [\n");
+    for (size_t i=0;i<names.size();i++) {
+        const CorpusStats &s=stats[i];
+        std::fprintf(f,"    {\"name\": \"%s\", \"puzzles\": %zu, \"solved\": %zu, "
+            "\"median_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, \"mean_us\": %.3f, "
+            "\"worst_index\": %zu, \"nodes_total\": %llu, \"nodes_median\": %llu, \"nodes_max\": %llu, "
+            "\"puzzles_per_sec\": %.1f}%s\n",
+            JsonEscape(names[i]).c_str(),s.count,s.solved,s.medianUs,s.p99Us,s.maxUs,s.meanUs,
+            s.worstIndex,(unsigned long long)s.nodesTotal,(unsigned long long)s.nodesMedian,
+            (unsigned long long)s.nodesMax,s.PuzzlesPerSec(),i+1<names.size() ? "," : "");
+    }
+    std::fprintf(f,"  ]\n}\n");
+}
+
+// Reads one number from a JSON file this tool wrote: the value of `key`
+// inside the corpus object named `corpus`. Returns false if absent.
+static bool BaselineValue(const std::string &json, const std::string &corpus, const std::string &key, double &out) {
+    size_t at=json.find("\"name\": \""+JsonEscape(corpus)+"\"");
+    if (at==std::string::npos) return false;
+    size_t end=json.find('}',at);
+    size_t k=json.find("\""+key+"\":",at);
+    if (k==std::string::npos || k>end) return false;
+    out=std::strtod(json.c_str()+k+key.size()+3,nullptr);
+    return true;
+}
+
+// ------------------- Bench Driver -------------------
+struct BenchOptions {
+    std::vector<std::string> files;
+    std::string jsonPath, baselinePath;
+    int repeat=3;
+    double tolerance=10.0;  // percent slowdown allowed against the baseline
+    int generated=20;       // 16x16 and 25x25 boards of each size
+    double largeLimitMs=1000.0;
+};
+
+static void PrintUsage(const char *argv0) {
+    std::fprintf(stderr,
+        "Usage: %s [corpus.txt ...] [--json out.json] [--repeat n] [--baseline old.json] [--tolerance pct]\n"
+        "          [--generated n] [--large-limit ms]\n"
+        "  Corpora default to puzzles/easy.txt, puzzles/hardest.txt and puzzles/17clue.txt.\n"
+        "  --generated also times n generated 16x16 and 25x25 boards (default 20, 0 to skip) and\n"
+        "  exits with 5 when one takes longer than --large-limit ms (default 1000) to solve.\n"
+        "  --json writes the results ('-' for stdout).\n"
+        "  --baseline compares median and p99 against an earlier --json run and exits with 4\n"
+        "  when any corpus is more than --tolerance percent (default 10) slower.\n",argv0);
+}
+
+static bool ParseArgs(int argc, char **argv, BenchOptions &opt) {
+    for (int i=1;i<argc;i++) {
+        std::string a=argv[i];
+        auto next=[&]()->const char* { return i+1<argc ? argv[++i] : nullptr; };
+        const char *v=nullptr;
+        if (a=="--json") { if (!(v=next())) return false; opt.jsonPath=v; }
+        else if (a=="--repeat") { if (!(v=next())) return false; opt.repeat=std::atoi(v); }
+        else if (a=="--baseline") { if (!(v=next())) return false; opt.baselinePath=v; }
+        else if (a=="--tolerance") { if (!(v=next())) return false; opt.tolerance=std::atof(v); }
+        else if (a=="--generated") { if (!(v=next())) return false; opt.generated=std::atoi(v); }
+        else if (a=="--large-limit") { if (!(v=next())) return false; opt.largeLimitMs=std::atof(v); }
+        else if (a=="-h"||a=="--help") return false;
+        else opt.files.push_back(a);
+    }
+    if (opt.repeat<1) opt.repeat=1;
+    if (opt.files.empty()) opt.files={"puzzles/easy.txt","puzzles/hardest.txt","puzzles/17clue.txt"};
+    return true;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opt;
+    if (!ParseArgs(argc,argv,opt)) { PrintUsage(argv[0]); return 2; }
+
+    std::vector<Corpus> corpora(opt.files.size());
+    for (size_t i=0;i<opt.files.size();i++)
+        if (!LoadCorpus(opt.files[i],corpora[i])) { std::fprintf(stderr,"Cannot open %s\n",opt.files[i].c_str()); return 1; }
+
+    std::vector<std::string> names;
+    std::vector<CorpusStats> stats;
+    bool allSolved=true, tooSlow=false;
+    std::fprintf(stderr,"%-10s %8s %10s %10s %10s %12s %12s %12s\n",
+        "corpus","puzzles","median us","p99 us","max us","nodes med","nodes max","puzzles/s");
+    auto report=[&](const std::string &name, const std::string &source, const CorpusStats &s) {
+        names.push_back(name);
+        stats.push_back(s);
+        std::fprintf(stderr,"%-10s %8zu %10.1f %10.1f %10.1f %12llu %12llu %12.0f\n",
+            name.c_str(),s.count,s.medianUs,s.p99Us,s.maxUs,
+            (unsigned long long)s.nodesMedian,(unsigned long long)s.nodesMax,s.PuzzlesPerSec());
+        if (s.solved!=s.count) {
+            std::fprintf(stderr,"  %zu of %zu puzzles in %s were not solved correctly\n",s.count-s.solved,s.count,source.c_str());
+            allSolved=false;
+        }
+    };
+    for (const Corpus &c: corpora) report(c.name,c.path,RunPuzzles<3>(c.puzzles,opt.repeat));
+
+    // The larger boards have no corpus; what matters is that the ones the GUI
+    // deals solve interactively.
+    auto large=[&](const char *name, const CorpusStats &s, double genMaxUs) {
+        report(name,"the generated boards",s);
+        std::fprintf(stderr,"  slowest generation %.1f ms\n",genMaxUs/1000);
+        if (s.maxUs>opt.largeLimitMs*1000) {
+            std::fprintf(stderr,"  slowest solve %.1f ms is over the %g ms limit\n",s.maxUs/1000,opt.largeLimitMs);
+            tooSlow=true;
+        }
+    };
+    if (opt.generated>0) {
+        double genMaxUs;
+        std::vector<GridT<4>> boards16=GenerateBoards<4>(opt.generated,genMaxUs);
+        large("gen16x16",RunPuzzles<4>(boards16,opt.repeat),genMaxUs);
+        std::vector<GridT<5>> boards25=GenerateBoards<5>(opt.generated,genMaxUs);
+        large("gen25x25",RunPuzzles<5>(boards25,opt.repeat),genMaxUs);
+    }
+
+    if (!opt.jsonPath.empty()) {
+        FILE *f=opt.jsonPath=="-" ? stdout : std::fopen(opt.jsonPath.c_str(),"w");
+        if (!f) { std::fprintf(stderr,"Cannot write %s\n",opt.jsonPath.c_str()); return 1; }
+        WriteJson(f,names,stats,opt.repeat);
+        if (f!=stdout) std::fclose(f);
+    }
+
+    bool regressed=false;
+    if (!opt.baselinePath.empty()) {
+        std::ifstream in(opt.baselinePath);
+        if (!in) { std::fprintf(stderr,"Cannot open %s\n",opt.baselinePath.c_str()); return 1; }
+        std::stringstream ss; ss<<in.rdbuf();
+        std::string json=ss.str();
+        for (size_t i=0;i<names.size();i++) {
+            const std::pair<const char*,double> metrics[]={{"median_us",stats[i].medianUs},{"p99_us",stats[i].p99Us}};
+            for (const auto &m: metrics) {
+                double before;
+                if (!BaselineValue(json,names[i],m.first,before) || before<=0) continue;
+                double change=(m.second-before)/before*100.0;
+                bool bad=change>opt.tolerance;
+                std::fprintf(stderr,"%-10s %-10s %10.1f -> %10.1f  (%+.1f%%)%s\n",names[i].c_str(),m.first,
+                    before,m.second,change,bad ? "  REGRESSION" : "");
+                regressed|=bad;
+            }
+        }
+    }
+
+    if (!allSolved) return 3;
+    if (regressed) return 4;
+    return tooSlow ? 5 : 0;
+}
@@ -0,0 +1,271 @@
+// Sudoku core shared by the GUI and the headless tools. No raylib dependency.
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// ------------------- Board Geometry -------------------
+// Everything is specialised on the box size B (3 for the classic 9x9, 4 for
+// 16x16, 5 for 25x25), so mask widths and loop bounds are compile-time
+// constants and the 9x9 path compiles to the same code as before.
+template <int B>
+struct Dims {
+    static constexpr int BOX = B;
+    static constexpr int SIDE = B*B;
+    static constexpr int CELLS = SIDE*SIDE;
+    using Mask = std::conditional_t<(SIDE<=16),uint16_t,uint32_t>;
+    using Cell = std::conditional_t<(CELLS<=256),uint8_t,uint16_t>;
+    static constexpr Mask ALL = Mask((uint64_t(1)<<SIDE)-1);
+
+    static constexpr int BoxOf(int r,int c) { return (r/B)*B + c/B; }
+};
+
+template <int B> using GridT = std::array<std::array<int,B*B>,B*B>;
+
+// Classic 9x9 names, used by the 9x9-only modules (DLX, generator, SIMD).
+using Grid = GridT<3>;
+static constexpr int N = Dims<3>::SIDE;
+static constexpr int BOX = Dims<3>::BOX;
+static constexpr uint16_t ALL_DIGITS = Dims<3>::ALL;
+
+constexpr int BoxOf(int r,int c) { return Dims<3>::BoxOf(r,c); }
+
+// ------------------- Sudoku Core -------------------
+template <int B=3>
+inline bool HasConflictAt(const GridT<B> &g, int r, int c) {
+    constexpr int S = B*B;
+    int val = g[r][c];
+    if (val == 0) return false;
+    for (int i = 0; i < S; i++) {
+        if (i != c && g[r][i] == val) return true;
+    }
+    for (int i = 0; i < S; i++) {
+        if (i != r && g[i][c] == val) return true;
+    }
+    int br = (r/B)*B, bc = (c/B)*B;
+    for (int i=0; i<B; i++)
+        for (int j=0; j<B; j++) {
+            int rr = br+i, cc = bc+j;
+            if (rr==r && cc==c) continue;
+            if (g[rr][cc] == val) return true;
+        }
+    return false;
+}
+
+template <int B=3>
+inline bool IsValidPlacement(const GridT<B> &g, int r, int c, int val) {
+    constexpr int S = B*B;
+    if (val == 0) return true;
+    for (int i=0; i<S; i++) {
+        if (g[r][i] == val) return false;
+        if (g[i][c] == val) return false;
+    }
+    int br=(r/B)*B, bc=(c/B)*B;
+    for (int i=0;i<B;i++)
+        for (int j=0;j<B;j++)
+            if (g[br+i][bc+j]==val) return false;
+    return true;
+}
+
+// ------------------- Bitmask Solver -------------------
+// Digits used in each row/column/box are kept as bit masks (bit v-1 for
+// digit v), so a cell's candidates are one OR away. The search propagates
+// naked and hidden singles, then branches on the cell with the fewest
+// candidates (MRV).
+
+// Cell indices of the 3*SIDE units: rows, then columns, then boxes.
+template <int B>
+using UnitTableT = std::array<std::array<typename Dims<B>::Cell,B*B>,3*B*B>;
+
+template <int B>
+constexpr UnitTableT<B> MakeUnits() {
+    using D = Dims<B>;
+    using Cell = typename D::Cell;
+    constexpr int S = D::SIDE;
+    UnitTableT<B> u{};
+    for (int i=0;i<S;i++) for (int k=0;k<S;k++) {
+        u[i][k]=Cell(i*S+k);
+        u[S+i][k]=Cell(k*S+i);
+        int r=(i/B)*B+k/B, c=(i%B)*B+k%B;
+        u[2*S+i][k]=Cell(r*S+c);
+    }
+    return u;
+}
+
+template <int B>
+struct Units { static constexpr UnitTableT<B> TABLE = MakeUnits<B>(); };
+
+using UnitTable = UnitTableT<3>;
+static constexpr const UnitTable &UNITS = Units<3>::TABLE;
+
+// Lets another thread watch and stop a running search. Counters are
+// relaxed: they are progress indicators, not synchronisation.
+struct SolveControl {
+    std::atomic<bool> cancel{false};
+    std::atomic<uint64_t> nodes{0};
+    std::atomic<int> depth{0};
+    uint64_t nodeLimit=0;           // gives up after this many nodes; 0: never
+
+    void Reset() { cancel=false; nodes=0; depth=0; }
+    bool Cancelled() const {
+        return cancel.load(std::memory_order_relaxed) || (nodeLimit && nodes.load(std::memory_order_relaxed)>=nodeLimit);
+    }
+    void Visit(int d) {
+        nodes.fetch_add(1,std::memory_order_relaxed);
+        depth.store(d,std::memory_order_relaxed);
+    }
+};
+
+template <int B>
+struct BitSolverT {
+    using D = Dims<B>;
+    using Mask = typename D::Mask;
+    static constexpr int S = D::SIDE;
+    static constexpr int CELLS = D::CELLS;
+
+    std::array<uint8_t,CELLS> cell{};
+    std::array<Mask,S> rowUsed{}, colUsed{}, boxUsed{};
+
+    Mask Candidates(int i) const {
+        int r=i/S, c=i%S;
+        return Mask(D::ALL & ~(rowUsed[r]|colUsed[c]|boxUsed[D::BoxOf(r,c)]));
+    }
+
+    void Place(int i,int v) {
+        int r=i/S, c=i%S;
+        Mask bit=Mask(1u<<(v-1));
+        cell[i]=uint8_t(v);
+        rowUsed[r]|=bit; colUsed[c]|=bit; boxUsed[D::BoxOf(r,c)]|=bit;
+    }
+
+    // Returns false if the givens already conflict.
+    bool Load(const GridT<B> &g) {
+        for (int r=0;r<S;r++) for (int c=0;c<S;c++) {
+            int v=g[r][c];
+            if (v==0) continue;
+            if (v<1||v>S) return false;
+            Mask bit=Mask(1u<<(v-1));
+            if ((rowUsed[r]|colUsed[c]|boxUsed[D::BoxOf(r,c)])&bit) return false;
+            Place(r*S+c,v);
+        }
+        return true;
+    }
+
+    void Store(GridT<B> &g) const {
+        for (int i=0;i<CELLS;i++) g[i/S][i%S]=cell[i];
+    }
+
+    // Fills every forced cell; returns false on a contradiction.
+    bool Propagate() {
+        bool changed=true;
+        while (changed) {
+            changed=false;
+            for (int i=0;i<CELLS;i++) {
+                if (cell[i]) continue;
+                Mask cand=Candidates(i);
+                if (!cand) return false;
+                if (!(cand&(cand-1))) { Place(i,__builtin_ctz(cand)+1); changed=true; }
+            }
+            for (const auto &unit: Units<B>::TABLE) {
+                Mask once=0, twice=0, used=0;
+                for (auto i: unit) {
+                    if (cell[i]) { used|=Mask(1u<<(cell[i]-1)); continue; }
+                    Mask cand=Candidates(i);
+                    twice|=once&cand; once|=cand;
+                }
+                if ((once|used)!=D::ALL) return false;
+                for (Mask single=Mask(once&~twice); single; single&=single-1) {
+                    Mask bit=single&-single;
+                    bool placed=false;
+                    for (auto i: unit) {
+                        if (!cell[i] && (Candidates(i)&bit)) {
+                            Place(i,__builtin_ctz(bit)+1); placed=changed=true;
+                            break;
+                        }
+                    }
+                    if (!placed) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Unfilled cell with the fewest candidates, or -1 when the grid is full.
+    int PickCell() const {
+        int best=-1, bestCount=S+1;
+        for (int i=0;i<CELLS;i++) {
+            if (cell[i]) continue;
+            int n=__builtin_popcount(Candidates(i));
+            if (n<bestCount) { best=i; bestCount=n; if (n==2) break; }
+        }
+        return best;
+    }
+
+    // A cancelled search returns false; check control->Cancelled() to tell
+    // it apart from an unsolvable grid.
+    bool Search(SolveControl *control=nullptr, int depth=0) {
+        if (control) {
+            if (control->Cancelled()) return false;
+            control->Visit(depth);
+        }
+        if (!Propagate()) return false;
+        int best=PickCell();
+        if (best<0) return true;
+        for (Mask cand=Candidates(best); cand; cand&=cand-1) {
+            BitSolverT next=*this;
+            next.Place(best,__builtin_ctz(cand)+1);
+            if (next.Search(control,depth+1)) { *this=next; return true; }
+        }
+        return false;
+    }
+};
+
+using BitSolver = BitSolverT<3>;
+
+template <int B=3>
+inline bool SolveSudoku(GridT<B> &g, SolveControl *control=nullptr) {
+    BitSolverT<B> s;
+    if (!s.Load(g) || !s.Search(control)) return false;
+    s.Store(g);
+    return true;
+}
+
+// ------------------- Utilities -------------------
+// Digits above 9 are written as letters: A=10, B=11, ... (P=25).
+inline char DigitChar(int v) { return v<=9 ? char('0'+v) : char('A'+v-10); }
+
+inline int DigitValue(char ch) {
+    if (ch>='1'&&ch<='9') return ch-'0';
+    if (ch>='A'&&ch<='Z') return ch-'A'+10;
+    if (ch>='a'&&ch<='z') return ch-'a'+10;
+    return 0;
+}
+
+// Reads SIDE*SIDE cells in row-major order, skipping whitespace. Anything
+// that isn't a digit of this board size ('0', '.', ...) is an empty cell.
+template <int B=3>
+inline GridT<B> ParsePuzzle(const std::string &s) {
+    constexpr int S = B*B;
+    GridT<B> g{}; for (auto &row:g) row.fill(0);
+    int idx=0;
+    for (char ch: s) {
+        if (ch=='\n'||ch==' '||ch=='\r'||ch=='\t') continue;
+        if (idx>=S*S) break;
+        int r=idx/S, c=idx%S;
+        int v=DigitValue(ch);
+        g[r][c]=(v>=1&&v<=S) ? v : 0;
+        idx++;
+    }
+    return g;
+}
+
+// Row-major one-char-per-cell form, '0' for empty cells.
+template <int B=3>
+inline std::string FormatGrid(const GridT<B> &g) {
+    constexpr int S = B*B;
+    std::string s(S*S,'0');
+    for (int r=0;r<S;r++) for (int c=0;c<S;c++) if (g[r][c]) s[r*S+c]=DigitChar(g[r][c]);
+    return s;
+}
@@ -0,0 +1,145 @@
+// Dancing Links (Algorithm X) exact-cover solver for counting solutions.
+#pragma once
+#include "SudokuCore.h"
+
+// ------------------- Exact Cover Matrix -------------------
+// 729 candidate rows (cell, digit) against 324 constraint columns:
+//   cell filled | row has digit | column has digit | box has digit.
+// The whole matrix lives in one fixed node arena built once per solver;
+// searches only relink nodes, so counting never allocates.
+class DlxSolver {
+public:
+    DlxSolver() { Build(); }
+
+    // Counts solutions of g, stopping as soon as `limit` are found. When
+    // `first` is set it receives the first solution found. Grids with
+    // conflicting givens have no solutions. A cancelled count returns the
+    // solutions found so far.
+    int Count(const Grid &g, int limit, Grid *first=nullptr, SolveControl *control=nullptr) {
+        if (limit<=0) return 0;
+        std::array<int16_t,N*N> givens{};
+        int givenCount=0;
+        std::array<uint16_t,N> rowUsed{}, colUsed{}, boxUsed{};
+        for (int r=0;r<N;r++) for (int c=0;c<N;c++) {
+            int v=g[r][c];
+            if (v==0) continue;
+            if (v<1||v>N) return 0;
+            uint16_t bit=uint16_t(1u<<(v-1));
+            int b=BoxOf(r,c);
+            if ((rowUsed[r]|colUsed[c]|boxUsed[b])&bit) return 0;
+            rowUsed[r]|=bit; colUsed[c]|=bit; boxUsed[b]|=bit;
+            givens[givenCount++]=int16_t((r*N+c)*N+v-1);
+        }
+
+        found=0; maxFound=limit; depth=0; firstOut=first; ctl=control;
+        for (int k=0;k<givenCount;k++) SelectRow(rowStart[givens[k]]);
+        if (first) *first=g;
+        Search();
+        for (int k=givenCount-1;k>=0;k--) UnselectRow(rowStart[givens[k]]);
+        return found;
+    }
+
+private:
+    static constexpr int COLS = 4*N*N;
+    static constexpr int ROWS = N*N*N;
+    static constexpr int ROOT = 0;
+
+    struct Node { int16_t l, r, u, d, col, row; };
+
+    std::array<Node,1+COLS+4*ROWS> node{};
+    std::array<int16_t,1+COLS> size{};
+    std::array<int16_t,ROWS> rowStart{};
+    std::array<int16_t,N*N> stack{};
+    int depth=0, found=0, maxFound=0;
+    Grid *firstOut=nullptr;
+    SolveControl *ctl=nullptr;
+
+    void Build() {
+        for (int c=0;c<=COLS;c++) {
+            node[c]=Node{int16_t(c==0?COLS:c-1), int16_t(c==COLS?0:c+1), int16_t(c), int16_t(c), int16_t(c), -1};
+            size[c]=0;
+        }
+        int next=COLS+1;
+        for (int r=0;r<N;r++) for (int c=0;c<N;c++) for (int d=0;d<N;d++) {
+            int row=(r*N+c)*N+d;
+            int cols[4]={1+r*N+c, 1+N*N+r*N+d, 1+2*N*N+c*N+d, 1+3*N*N+BoxOf(r,c)*N+d};
+            rowStart[row]=int16_t(next);
+            for (int k=0;k<4;k++) {
+                int i=next+k, col=cols[k];
+                Node &n=node[i];
+                n.col=int16_t(col); n.row=int16_t(row);
+                n.l=int16_t(next+(k+3)%4); n.r=int16_t(next+(k+1)%4);
+                n.d=int16_t(col); n.u=node[col].u;
+                node[node[col].u].d=int16_t(i); node[col].u=int16_t(i);
+                size[col]++;
+            }
+            next+=4;
+        }
+    }
+
+    void Cover(int c) {
+        node[node[c].r].l=node[c].l; node[node[c].l].r=node[c].r;
+        for (int i=node[c].d;i!=c;i=node[i].d)
+            for (int j=node[i].r;j!=i;j=node[j].r) {
+                node[node[j].d].u=node[j].u; node[node[j].u].d=node[j].d;
+                size[node[j].col]--;
+            }
+    }
+
+    void Uncover(int c) {
+        for (int i=node[c].u;i!=c;i=node[i].u)
+            for (int j=node[i].l;j!=i;j=node[j].l) {
+                size[node[j].col]++;
+                node[node[j].d].u=int16_t(j); node[node[j].u].d=int16_t(j);
+            }
+        node[node[c].r].l=int16_t(c); node[node[c].l].r=int16_t(c);
+    }
+
+    void SelectRow(int i) {
+        Cover(node[i].col);
+        for (int j=node[i].r;j!=i;j=node[j].r) Cover(node[j].col);
+    }
+
+    void UnselectRow(int i) {
+        for (int j=node[i].l;j!=i;j=node[j].l) Uncover(node[j].col);
+        Uncover(node[i].col);
+    }
+
+    void Search() {
+        if (ctl) {
+            if (ctl->Cancelled()) { maxFound=found; return; }
+            ctl->Visit(depth);
+        }
+        if (node[ROOT].r==ROOT) {
+            if (++found==1 && firstOut)
+                for (int k=0;k<depth;k++) {
+                    int row=stack[k], cell=row/N;
+                    (*firstOut)[cell/N][cell%N]=row%N+1;
+                }
+            return;
+        }
+        int best=node[ROOT].r;
+        for (int c=node[best].r;c!=ROOT;c=node[c].r)
+            if (size[c]<size[best]) { best=c; if (size[c]<=1) break; }
+        if (size[best]==0) return;
+
+        Cover(best);
+        for (int i=node[best].d;i!=best && found<maxFound;i=node[i].d) {
+            stack[depth++]=node[i].row;
+            for (int j=node[i].r;j!=i;j=node[j].r) Cover(node[j].col);
+            Search();
+            for (int j=node[i].l;j!=i;j=node[j].l) Uncover(node[j].col);
+            depth--;
+        }
+        Uncover(best);
+    }
+};
+
+// Number of solutions of g, capped at `limit`. CountSolutions(g,2)==1 is
+// the cheap uniqueness test. Each thread reuses its own solver arena.
+inline int CountSolutions(const Grid &g, int limit, SolveControl *control=nullptr) {
+    static thread_local DlxSolver solver;
+    return solver.Count(g,limit,nullptr,control);
+}
+
+inline bool HasUniqueSolution(const Grid &g) { return CountSolutions(g,2)==1; }
@@ -1,213 +1,447 @@
 #include <raylib.h>
-#include <array>
-#include <string>
-#include <optional>
+#include <algorithm>
 #include <random>
-
-static constexpr int N = 9;
-using Grid = std::array<std::array<int, N>, N>;
-
-// ------------------- Sudoku Core -------------------
-bool HasConflictAt(const Grid &g, int r, int c) {
-    int val = g[r][c];
-    if (val == 0) return false;
-    for (int i = 0; i < N; i++) {
-        if (i != c && g[r][i] == val) return true;
-    }
-    for (int i = 0; i < N; i++) {
-        if (i != r && g[i][c] == val) return true;
-    }
-    int br = (r/3)*3, bc = (c/3)*3;
-    for (int i=0; i<3; i++)
-        for (int j=0; j<3; j++) {
-            int rr = br+i, cc = bc+j;
-            if (rr==r && cc==c) continue;
-            if (g[rr][cc] == val) return true;
-        }
-    return false;
-}
-
-bool IsValidPlacement(const Grid &g, int r, int c, int val) {
-    if (val == 0) return true;
-    for (int i=0; i<N; i++) {
-        if (g[r][i] == val) return false;
-        if (g[i][c] == val) return false;
-    }
-    int br=(r/3)*3, bc=(c/3)*3;
-    for (int i=0;i<3;i++)
-        for (int j=0;j<3;j++)
-            if (g[br+i][bc+j]==val) return false;
-    return true;
-}
-
-std::optional<std::pair<int,int>> FindEmpty(const Grid &g) {
-    for (int r=0;r<N;r++)
-        for (int c=0;c<N;c++)
-            if (g[r][c]==0) return std::make_pair(r,c);
-    return std::nullopt;
-}
-
-bool SolveSudoku(Grid &g) {
-    auto empty = FindEmpty(g);
-    if (!empty) return true;
-    auto [r,c] = *empty;
-    for (int num=1; num<=9; num++) {
-        if (IsValidPlacement(g,r,c,num)) {
-            g[r][c] = num;
-            if (SolveSudoku(g)) return true;
-            g[r][c] = 0;
-        }
-    }
-    return false;
-}
-
-// ------------------- Utilities -------------------
-Grid ParsePuzzle(const std::string &s) {
-    Grid g{}; for (auto &row:g) row.fill(0);
-    int idx=0;
-    for (char ch: s) {
-        if (ch=='\n'||ch==' '||ch=='\r'||ch=='\t') continue;
-        if (idx>=81) break;
-        int r=idx/9, c=idx%9;
-        if (ch>='1'&&ch<='9') g[r][c]=ch-'0';
-        else g[r][c]=0;
-        idx++;
-    }
-    return g;
-}
-
-Grid GenerateRandomPuzzle() {
-    Grid g{}; for (auto &row: g) row.fill(0);
-    std::random_device rd; std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dist(1,9);
-    // fill diagonal boxes
-    for (int k=0;k<9;k+=3) {
-        for (int i=0;i<3;i++)
-            for (int j=0;j<3;j++) {
-                int val;
-                do { val=dist(gen);} while(!IsValidPlacement(g,k+i,k+j,val));
-                g[k+i][k+j]=val;
-            }
-    }
-    Grid solved=g;
-    SolveSudoku(solved);
-    std::uniform_int_distribution<> dcell(0,80);
-    for (int k=0;k<40;k++) {
-        int idx=dcell(gen);
-        solved[idx/9][idx%9]=0;
-    }
-    return solved;
-}
+#include <string>
+#include <thread>
+#include "SudokuCore.h"
+#include "SudokuDLX.h"
+#include "SudokuGenerator.h"
+#include "SudokuValidate.h"
+#include "SudokuTrace.h"
 
 // ------------------- GUI State -------------------
+template <int B>
 struct GUIState {
-    Grid grid{};
-    Grid given{};
-    Grid solution{};
+    GridT<B> grid{};
+    GridT<B> given{};
+    GridT<B> solution{};
     bool hasSolution=false;
+    int solutionCount=0;    // capped at 2 by the solve worker
+    bool solving=false;     // edits are locked while a solve is in flight
     int selRow=-1, selCol=-1;
+    ConflictTrackerT<B> conflicts;  // mirrors `grid`; every edit goes through it
+    Difficulty level=Difficulty::Medium;
+    std::string notice;
 };
 
 bool PointInRect(Vector2 p, Rectangle r) {
     return p.x>=r.x && p.x<=r.x+r.width && p.y>=r.y && p.y<=r.y+r.height;
 }
 
+// Replaces the whole grid, e.g. for a new puzzle, a reset or a solution.
+template <int B>
+void LoadGrid(GUIState<B> &st, const GridT<B> &g) {
+    st.grid=g;
+    st.conflicts.Reset(g);
+}
+
+// ------------------- Trace Replay -------------------
+// Steps through a recorded search on a copy of the board. The trace is
+// written only by the solve worker and read here after the result is polled.
+struct TraceReplay {
+    SolveTrace trace;
+    bool active=false, paused=false;
+    size_t pos=0;               // records applied to `view`
+    int stepsPerFrame=4;
+    Grid view{};
+    int lastCell=-1;
+    TraceOp lastOp=TraceOp::Force;
+
+    void Start() { active=true; paused=false; Rewind(); }
+    void Stop() { active=false; }
+
+    void Rewind() { view=trace.Base(); pos=0; lastCell=-1; }
+
+    void Seek(size_t target) {
+        target=std::min(target,trace.Size());
+        if (target<pos) Rewind();
+        while (pos<target) {
+            uint16_t rec=trace.At(pos++);
+            SolveTrace::Apply(view,rec);
+            lastCell=TraceCell(rec); lastOp=TraceOpOf(rec);
+        }
+    }
+
+    void Advance() { if (active && !paused) Seek(pos+stepsPerFrame); }
+};
+
 // ------------------- GUI Functions -------------------
-void DrawGrid(const GUIState &st, Rectangle board) {
-    float cellW=board.width/9.0f, cellH=board.height/9.0f;
+// `replay` is only consulted on 9x9 boards, the only size that records traces.
+template <int B>
+void DrawGrid(const GUIState<B> &st, const TraceReplay &replay, Rectangle board) {
+    constexpr int S = B*B;
+    const float fontSize = B==3 ? 28.0f : B==4 ? 18.0f : 12.0f;
+    const ConflictMapT<B> &conflicts=st.conflicts.Map();
+    const GridT<B> *cells=&st.grid;
+    bool replaying=false;
+    if constexpr (B==3) {
+        replaying=replay.active;
+        if (replaying) cells=&replay.view;
+    }
+    float cellW=board.width/S, cellH=board.height/S;
     DrawRectangleRec(board, RAYWHITE);
 
-    for (int br=0;br<3;br++) for (int bc=0;bc<3;bc++) {
+    for (int br=0;br<B;br++) for (int bc=0;bc<B;bc++) {
         if ((br+bc)%2==1) {
-            Rectangle box{board.x+bc*3*cellW, board.y+br*3*cellH,3*cellW,3*cellH};
+            Rectangle box{board.x+bc*B*cellW, board.y+br*B*cellH,B*cellW,B*cellH};
             DrawRectangleRec(box, Fade(LIGHTGRAY,0.2f));
         }
     }
 
-    for (int r=0;r<9;r++) for (int c=0;c<9;c++) {
-        if (HasConflictAt(st.grid,r,c)) {
+    for (int r=0;r<S;r++) for (int c=0;c<S;c++) {
+        if (!replaying && conflicts.At(r,c)) {
             Rectangle cell{board.x+c*cellW, board.y+r*cellH, cellW, cellH};
             DrawRectangleRec(cell, Color{255,200,200,255});
         }
     }
 
+    if (replaying && replay.lastCell>=0) {
+        int r=replay.lastCell/S, c=replay.lastCell%S;
+        Color mark=replay.lastOp==TraceOp::Undo ? ORANGE : replay.lastOp==TraceOp::Guess ? SKYBLUE : GREEN;
+        DrawRectangleRec(Rectangle{board.x+c*cellW, board.y+r*cellH, cellW, cellH}, Fade(mark,0.5f));
+    }
+
     if (st.selRow>=0&&st.selCol>=0) {
         Rectangle sel{board.x+st.selCol*cellW,board.y+st.selRow*cellH,cellW,cellH};
         DrawRectangleRec(sel, Fade(LIGHTGRAY,0.3f));
     }
 
     Font f=GetFontDefault();
-    for (int r=0;r<9;r++) for (int c=0;c<9;c++) {
-        int val=st.grid[r][c]; if (!val) continue;
-        std::string s(1,char('0'+val));
-        Vector2 sz=MeasureTextEx(f,s.c_str(),28,2);
+    for (int r=0;r<S;r++) for (int c=0;c<S;c++) {
+        int val=(*cells)[r][c]; if (!val) continue;
+        char s[2]={DigitChar(val),'\0'};
+        Vector2 sz=MeasureTextEx(f,s,fontSize,2);
         float cx=board.x+c*cellW+(cellW-sz.x)/2;
         float cy=board.y+r*cellH+(cellH-sz.y)/2-2;
         Color col=(st.given[r][c]==0)? BLUE: BLACK;
-        if (HasConflictAt(st.grid,r,c)) col=RED;
-        DrawTextEx(f,s.c_str(),{cx,cy},28,2,col);
+        if (!replaying && conflicts.At(r,c)) col=RED;
+        DrawTextEx(f,s,{cx,cy},fontSize,2,col);
     }
 
-    for (int i=0;i<=9;i++) {
+    for (int i=0;i<=S;i++) {
         float x=board.x+i*cellW, y=board.y+i*cellH;
-        int thick=(i%3==0)?3:1;
+        int thick=(i%B==0)?3:1;
         DrawLineEx({x,board.y},{x,board.y+board.height},thick,BLACK);
         DrawLineEx({board.x,y},{board.x+board.width,y},thick,BLACK);
     }
 }
 
-void HandleMouse(GUIState &st, Rectangle board) {
+template <int B>
+void HandleMouse(GUIState<B> &st, Rectangle board) {
+    constexpr int S = B*B;
     if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
         Vector2 m=GetMousePosition();
         if (PointInRect(m,board)) {
-            float cellW=board.width/9.0f, cellH=board.height/9.0f;
-            int c=(int)((m.x-board.x)/cellW);
-            int r=(int)((m.y-board.y)/cellH);
+            float cellW=board.width/S, cellH=board.height/S;
+            int c=std::min(S-1,(int)((m.x-board.x)/cellW));
+            int r=std::min(S-1,(int)((m.y-board.y)/cellH));
             st.selRow=r; st.selCol=c;
         }
     }
 }
 
-void SetCell(GUIState &st,int r,int c,int val) {
-    if (r<0||c<0||r>=9||c>=9) return;
-    if (st.given[r][c]!=0) return;
+template <int B>
+void SetCell(GUIState<B> &st,int r,int c,int val) {
+    constexpr int S = B*B;
+    if (r<0||c<0||r>=S||c>=S) return;
+    if (st.given[r][c]!=0 || st.solving) return;
     st.grid[r][c]=val;
+    st.conflicts.Update(r,c,val);
     st.hasSolution=false;
 }
 
-void HandleKeyboard(GUIState &st) {
+// Digits 1-9 come from the number row; boards larger than 9x9 continue
+// with letters (A=10 ... P=25), matching DigitChar.
+template <int B>
+void HandleKeyboard(GUIState<B> &st) {
+    constexpr int S = B*B;
     if (st.selRow>=0&&st.selCol>=0) {
-        for (int num=1;num<=9;num++) {
-            int key=KEY_ZERO+num;
+        for (int num=1;num<=S;num++) {
+            int key=num<=9 ? KEY_ZERO+num : KEY_A+(num-10);
             if (IsKeyPressed(key)) SetCell(st,st.selRow,st.selCol,num);
         }
         if (IsKeyPressed(KEY_ZERO)||IsKeyPressed(KEY_BACKSPACE)||IsKeyPressed(KEY_DELETE))
             SetCell(st,st.selRow,st.selCol,0);
     }
     if (IsKeyPressed(KEY_UP)) st.selRow = st.selRow>0?st.selRow-1:st.selRow;
-    if (IsKeyPressed(KEY_DOWN)) st.selRow = st.selRow<8?st.selRow+1:st.selRow;
+    if (IsKeyPressed(KEY_DOWN)) st.selRow = st.selRow<S-1?st.selRow+1:st.selRow;
     if (IsKeyPressed(KEY_LEFT)) st.selCol = st.selCol>0?st.selCol-1:st.selCol;
-    if (IsKeyPressed(KEY_RIGHT)) st.selCol = st.selCol<8?st.selCol+1:st.selCol;
+    if (IsKeyPressed(KEY_RIGHT)) st.selCol = st.selCol<S-1?st.selCol+1:st.selCol;
 }
 
-bool SolveAndSnapshot(GUIState &st) {
-    Grid tmp=st.grid;
-    if (SolveSudoku(tmp)) {
-        st.solution=tmp;
-        st.grid=tmp;
-        st.hasSolution=true;
+// ------------------- Async Solve -------------------
+template <int B>
+struct SolveResult {
+    GridT<B> grid{};
+    bool solved=false, cancelled=false, traced=false;
+    int solutionCount=0;
+};
+
+// Runs the solve on a worker thread so a pathological grid can't freeze the
+// window. The main loop polls it once per frame and applies the result on
+// the render thread, so GUIState is never shared with the worker.
+template <int B>
+class AsyncSolver {
+public:
+    ~AsyncSolver() { Cancel(); }
+
+    bool Running() const { return worker.joinable(); }
+    uint64_t Nodes() const { return control.nodes.load(std::memory_order_relaxed); }
+    int Depth() const { return control.depth.load(std::memory_order_relaxed); }
+    double Elapsed() const { return GetTime()-startTime; }
+
+    // With a trace (9x9 only), the search is recorded into it for replay;
+    // the caller must leave the trace alone until Poll() hands back the
+    // result. Solution counting is 9x9-only too; larger boards report 0.
+    void Start(const GridT<B> &g, SolveTrace *trace=nullptr) {
+        Cancel();
+        control.Reset();
+        finished=false;
+        startTime=GetTime();
+        worker=std::thread([this,g,trace]{
+            SolveResult<B> r;
+            r.grid=g;
+            if constexpr (B==3) {
+                r.traced=trace!=nullptr;
+                r.solved=trace ? SolveSudokuTraced(r.grid,*trace,&control) : SolveSudoku(r.grid,&control);
+                if (r.solved) r.solutionCount=CountSolutions(g,2,&control);
+            } else {
+                (void)trace;
+                r.solved=SolveSudoku<B>(r.grid,&control);
+            }
+            r.cancelled=control.Cancelled();
+            result=r;
+            finished.store(true,std::memory_order_release);
+        });
+    }
+
+    void Cancel() {
+        if (!Running()) return;
+        control.cancel=true;
+        worker.join();
+    }
+
+    // Hands over the result once the worker is done.
+    bool Poll(SolveResult<B> &out) {
+        if (!Running() || !finished.load(std::memory_order_acquire)) return false;
+        worker.join();
+        out=result;
         return true;
     }
+
+private:
+    std::thread worker;
+    SolveControl control;
+    std::atomic<bool> finished{false};
+    SolveResult<B> result;
+    double startTime=0;
+};
+
+template <int B>
+void StartSolve(GUIState<B> &st, AsyncSolver<B> &solver, SolveTrace *trace=nullptr) {
+    st.solving=true;
     st.hasSolution=false;
-    return false;
+    st.notice.clear();
+    solver.Start(st.grid,trace);
 }
 
-void ClearEditable(GUIState &st) {
-    for (int r=0;r<9;r++) for (int c=0;c<9;c++)
-        if (st.given[r][c]==0) st.grid[r][c]=0;
+template <int B>
+void CancelSolve(GUIState<B> &st, AsyncSolver<B> &solver) {
+    solver.Cancel();
+    st.solving=false;
+}
+
+template <int B>
+void ApplySolveResult(GUIState<B> &st, const SolveResult<B> &r) {
+    st.solving=false;
+    if (r.cancelled) { st.notice="Solve cancelled."; return; }
+    if (!r.solved) { st.notice="No solution exists for this grid."; return; }
+    st.solution=r.grid;
+    st.solutionCount=r.solutionCount;
+    LoadGrid(st,r.grid);
+    st.hasSolution=true;
+}
+
+template <int B>
+void ClearEditable(GUIState<B> &st) {
+    constexpr int S = B*B;
+    for (int r=0;r<S;r++) for (int c=0;c<S;c++)
+        if (st.given[r][c]==0) { st.grid[r][c]=0; st.conflicts.Update(r,c,0); }
     st.hasSolution=false;
 }
 
+// ------------------- Boards -------------------
+// One board per supported size; only the selected one is updated and drawn,
+// the others keep their state until the user switches back.
+template <int B>
+struct Board {
+    GUIState<B> st;
+    AsyncSolver<B> solver;
+};
+
+// Controls shared by every board size.
+struct Layout {
+    Rectangle board{50,120,500,500};
+    Rectangle btnSize{430,15,120,30};
+    Rectangle btnNew{50,640,320,40};
+    Rectangle btnLevel{380,640,170,40};
+    Rectangle btnSolve{50,690,140,40};
+    Rectangle btnClear{230,690,140,40};
+    Rectangle btnReset{410,690,140,40};
+
+    Rectangle btnAnimate{50,740,130,36};
+    Rectangle btnPause{190,740,100,36};
+    Rectangle btnSlower{300,740,36,36};
+    Rectangle btnFaster{346,740,36,36};
+    Rectangle btnExport{450,740,100,36};
+    Rectangle scrubBar{50,786,500,12};
+};
+
+void DrawButton(Rectangle r,const char *lbl) {
+    Color base=LIGHTGRAY;
+    if (PointInRect(GetMousePosition(),r)) base=GRAY;
+    DrawRectangleRounded(r,0.2f,6,base);
+    DrawRectangleRoundedLines(r,0.2f,6,BLACK);
+    int tw=MeasureText(lbl,18);
+    DrawText(lbl,(int)(r.x+(r.width-tw)/2),(int)(r.y+(r.height-18)/2),18,BLACK);
+}
+
+// Graded, uniqueness-checked puzzles come from the pool (9x9 only); larger
+// boards get a quick puzzle with ~45% of the cells given that singles alone
+// solve, so it is unique and Solve answers at once.
+template <int B>
+void NewPuzzle(Board<B> &b, PuzzlePool &pool, std::mt19937 &rng, TraceReplay &replay) {
+    GUIState<B> &st=b.st;
+    GridT<B> next;
+    if constexpr (B==3) {
+        if (!pool.TryPop(st.level,next)) {
+            st.notice=std::string("Still generating ")+DifficultyName(st.level)+" puzzles, try again shortly.";
+            return;
+        }
+    } else {
+        (void)pool;
+        next=GenerateQuickPuzzle<B>(B*B*B*B*45/100,rng);
+    }
+    CancelSolve(st,b.solver);
+    replay.Stop();
+    LoadGrid(st,next);
+    st.given=st.grid;
+    st.hasSolution=false;
+    st.notice.clear();
+}
+
+template <int B>
+void UpdateBoard(Board<B> &b, const Layout &ui, PuzzlePool &pool, std::mt19937 &rng, TraceReplay &replay) {
+    GUIState<B> &st=b.st;
+    SolveResult<B> solved;
+    if (b.solver.Poll(solved)) {
+        ApplySolveResult(st,solved);
+        if (solved.traced && !solved.cancelled) replay.Start();
+    }
+
+    HandleMouse(st,ui.board);
+    if (!replay.active) HandleKeyboard(st);
+
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        Vector2 m=GetMousePosition();
+        bool classic=B==3;
+        if (PointInRect(m,ui.btnNew)) {
+            NewPuzzle(b,pool,rng,replay);
+        } else if (PointInRect(m,ui.btnLevel)) {
+            if (classic) {
+                st.level=(Difficulty)(((int)st.level+1)%DIFFICULTY_COUNT);
+                st.notice.clear();
+            } else st.notice="Difficulty levels are only graded for 9x9 puzzles.";
+        } else if (PointInRect(m,ui.btnSolve)) {
+            replay.Stop();
+            if (st.solving) {
+                CancelSolve(st,b.solver);
+                st.notice="Solve cancelled.";
+            } else StartSolve(st,b.solver);
+        } else if (PointInRect(m,ui.btnClear)) {
+            CancelSolve(st,b.solver);
+            replay.Stop();
+            ClearEditable(st);
+        } else if (PointInRect(m,ui.btnReset)) {
+            CancelSolve(st,b.solver);
+            replay.Stop();
+            LoadGrid(st,st.given);
+            st.hasSolution=false;
+        } else if (PointInRect(m,ui.btnAnimate)) {
+            if (!classic) st.notice="Search replay is only recorded for 9x9 puzzles.";
+            else if (replay.active) replay.Stop();
+            else if (!st.solving) StartSolve(st,b.solver,&replay.trace);
+        } else if (PointInRect(m,ui.btnPause)) {
+            replay.paused=!replay.paused;
+        } else if (PointInRect(m,ui.btnSlower)) {
+            replay.stepsPerFrame=std::max(1,replay.stepsPerFrame/2);
+        } else if (PointInRect(m,ui.btnFaster)) {
+            replay.stepsPerFrame=std::min(4096,replay.stepsPerFrame*2);
+        } else if (PointInRect(m,ui.btnExport)) {
+            if (!classic) st.notice="Search replay is only recorded for 9x9 puzzles.";
+            else if (st.solving || replay.trace.Total()==0) st.notice="Nothing to export yet: press Animate first.";
+            else if (replay.trace.Export("sudoku_trace.bin"))
+                st.notice=TextFormat("Exported %zu trace records to sudoku_trace.bin",replay.trace.Size());
+            else st.notice="Could not write sudoku_trace.bin";
+        }
+    }
+
+    // Dragging the scrub bar seeks the replay and pauses it.
+    Rectangle scrubHit{ui.scrubBar.x,ui.scrubBar.y-6,ui.scrubBar.width,ui.scrubBar.height+12};
+    if (replay.active && IsMouseButtonDown(MOUSE_LEFT_BUTTON) && PointInRect(GetMousePosition(),scrubHit)) {
+        float t=(GetMousePosition().x-ui.scrubBar.x)/ui.scrubBar.width;
+        replay.paused=true;
+        replay.Seek((size_t)(std::clamp(t,0.0f,1.0f)*replay.trace.Size()));
+    }
+    replay.Advance();
+}
+
+template <int B>
+void DrawBoard(const Board<B> &b, const Layout &ui, const TraceReplay &replay) {
+    const GUIState<B> &st=b.st;
+    DrawText("Sudoku Solver (Backtracking)",50,15,24,BLACK);
+    if (B==3) DrawText("Click a cell, type 1-9 to enter. 0/Backspace to clear.",50,50,18,DARKGRAY);
+    else DrawText(TextFormat("Click a cell, type 1-9 or A-%c. 0/Backspace to clear.",DigitChar(B*B)),50,50,18,DARKGRAY);
+    DrawText("Use Arrow keys to navigate.",50,75,18,DARKGRAY);
+
+    DrawGrid(st,replay,ui.board);
+
+    DrawButton(ui.btnSize,TextFormat("Size: %dx%d",B*B,B*B));
+    DrawButton(ui.btnNew,"New Puzzle");
+    DrawButton(ui.btnLevel,B==3 ? TextFormat("Level: %s",DifficultyName(st.level)) : "Level: -");
+    DrawButton(ui.btnSolve,st.solving ? "Cancel" : "Solve");
+    DrawButton(ui.btnClear,"Clear");
+    DrawButton(ui.btnReset,"Reset");
+    DrawButton(ui.btnAnimate,replay.active ? "Close Replay" : "Animate");
+    DrawButton(ui.btnPause,replay.paused ? "Play" : "Pause");
+    DrawButton(ui.btnSlower,"-");
+    DrawButton(ui.btnFaster,"+");
+    DrawText(TextFormat("%d/frame",replay.stepsPerFrame),388,749,16,DARKGRAY);
+    DrawButton(ui.btnExport,"Export");
+
+    DrawRectangleRec(ui.scrubBar,LIGHTGRAY);
+    if (replay.active && replay.trace.Size()>0) {
+        float t=(float)replay.pos/replay.trace.Size();
+        DrawRectangleRec(Rectangle{ui.scrubBar.x,ui.scrubBar.y,ui.scrubBar.width*t,ui.scrubBar.height},SKYBLUE);
+        DrawRectangleRec(Rectangle{ui.scrubBar.x+ui.scrubBar.width*t-3,ui.scrubBar.y-4,6,ui.scrubBar.height+8},DARKBLUE);
+    }
+
+    if (st.solving) {
+        DrawText(TextFormat("Solving... %llu nodes, depth %d (%.1fs)",(unsigned long long)b.solver.Nodes(),b.solver.Depth(),b.solver.Elapsed()),50,815,20,DARKBLUE);
+    } else if (replay.active) {
+        DrawText(TextFormat("Step %zu/%zu  (%llu guesses, %llu undos)",replay.pos,replay.trace.Size(),
+            (unsigned long long)replay.trace.Guesses(),(unsigned long long)replay.trace.Undos()),50,815,20,DARKBLUE);
+    } else if (st.hasSolution) {
+        const char *msg=st.solutionCount>1 ? "Solved! (puzzle has multiple solutions)"
+                       : st.solutionCount==1 ? "Solved! (unique solution)" : "Solved!";
+        DrawText(msg,50,815,20,DARKGREEN);
+    } else {
+        if (st.conflicts.IsSolved()) DrawText("Completed (Valid)",50,815,20,DARKGREEN);
+        else DrawText("Press Solve or keep entering numbers.",50,815,20,DARKGRAY);
+    }
+    if (!st.notice.empty()) DrawText(st.notice.c_str(),50,845,18,MAROON);
+}
+
 // ------------------- Main -------------------
 int main() {
     const char *puzzle=
@@ -221,77 +455,50 @@ int main() {
         "000419005\n"
         "000080079";
 
-    GUIState st{};
-    st.grid=ParsePuzzle(puzzle);
-    st.given=st.grid;
-
-    const int screenW=600, screenH=820;
+    PuzzlePool pool;
+    TraceReplay replay;
+    std::mt19937 rng(std::random_device{}());
+    Board<3> b9;
+    Board<4> b16;
+    Board<5> b25;
+    LoadGrid(b9.st,ParsePuzzle(puzzle));
+    b9.st.given=b9.st.grid;
+    LoadGrid(b16.st,GenerateQuickPuzzle<4>(16*16*45/100,rng));
+    b16.st.given=b16.st.grid;
+    LoadGrid(b25.st,GenerateQuickPuzzle<5>(25*25*45/100,rng));
+    b25.st.given=b25.st.grid;
+    int boxSize=3;
+
+    const int screenW=600, screenH=880;
     InitWindow(screenW,screenH,"Sudoku");
     SetTargetFPS(60);
 
-    Rectangle board{50,120,500,500}; 
-
-    Rectangle btnNew{50,640,500,40};
-    Rectangle btnSolve{50,690,140,40};
-    Rectangle btnClear{230,690,140,40};
-    Rectangle btnReset{410,690,140,40};
+    Layout ui;
 
     while (!WindowShouldClose()) {
-        HandleMouse(st,board);
-        HandleKeyboard(st);
-
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            Vector2 m=GetMousePosition();
-            if (PointInRect(m,btnNew)) {
-                st.grid=GenerateRandomPuzzle();
-                st.given=st.grid;
-                st.hasSolution=false;
-            } else if (PointInRect(m,btnSolve)) {
-                SolveAndSnapshot(st);
-            } else if (PointInRect(m,btnClear)) {
-                ClearEditable(st);
-            } else if (PointInRect(m,btnReset)) {
-                st.grid=st.given;
-                st.hasSolution=false;
-            }
+        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && PointInRect(GetMousePosition(),ui.btnSize)) {
+            replay.Stop();
+            boxSize=boxSize==5 ? 3 : boxSize+1;
+        }
+        switch (boxSize) {
+            case 3: UpdateBoard(b9,ui,pool,rng,replay); break;
+            case 4: UpdateBoard(b16,ui,pool,rng,replay); break;
+            default: UpdateBoard(b25,ui,pool,rng,replay); break;
         }
 
         BeginDrawing();
         ClearBackground(Color{245,245,245,255});
-        DrawText("Sudoku Solver (Backtracking)",50,15,24,BLACK);
-        DrawText("Click a cell, type 1-9 to enter. 0/Backspace to clear.",50,50,18,DARKGRAY);
-        DrawText("Use Arrow keys to navigate.",50,75,18,DARKGRAY);
-
-        DrawGrid(st,board);
-
-        auto drawBtn=[&](Rectangle r,const char*lbl){
-            Color base=LIGHTGRAY;
-            if (PointInRect(GetMousePosition(),r)) base=GRAY;
-            DrawRectangleRounded(r,0.2f,6,base);
-            DrawRectangleRoundedLines(r,0.2f,6,BLACK);
-            int tw=MeasureText(lbl,18);
-            DrawText(lbl,(int)(r.x+(r.width-tw)/2),(int)(r.y+(r.height-18)/2),18,BLACK);
-        };
-
-        drawBtn(btnNew,"New Puzzle");
-        drawBtn(btnSolve,"Solve");
-        drawBtn(btnClear,"Clear");
-        drawBtn(btnReset,"Reset");
-
-        if (st.hasSolution) {
-            DrawText("Solved!",50,750,20,DARKGREEN);
-        } else {
-            bool full=true, valid=true;
-            for (int r=0;r<9;r++) for (int c=0;c<9;c++) {
-                if (st.grid[r][c]==0) full=false;
-                else if (HasConflictAt(st.grid,r,c)) valid=false;
-            }
-            if (full && valid) DrawText("Completed (Valid)",50,750,20,DARKGREEN);
-            else DrawText("Press Solve or keep entering numbers.",50,750,20,DARKGRAY);
+        switch (boxSize) {
+            case 3: DrawBoard(b9,ui,replay); break;
+            case 4: DrawBoard(b16,ui,replay); break;
+            default: DrawBoard(b25,ui,replay); break;
         }
         EndDrawing();
     }
 
+    b9.solver.Cancel();
+    b16.solver.Cancel();
+    b25.solver.Cancel();
     CloseWindow();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,328 @@
+// Puzzle generation: uniqueness-preserving clue removal, difficulty grading
+// by required solving technique, and a background pool of ready puzzles.
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+#include "SudokuCore.h"
+#include "SudokuDLX.h"
+
+// ------------------- Difficulty -------------------
+// Graded by the hardest technique a logical solver needs:
+//   Easy   - naked and hidden singles
+//   Medium - locked candidates (pointing / claiming)
+//   Hard   - naked pairs and triples
+//   Expert - none of the above suffice, guessing is required
+enum class Difficulty { Easy, Medium, Hard, Expert };
+static constexpr int DIFFICULTY_COUNT = 4;
+
+inline const char *DifficultyName(Difficulty d) {
+    switch (d) {
+        case Difficulty::Easy: return "Easy";
+        case Difficulty::Medium: return "Medium";
+        case Difficulty::Hard: return "Hard";
+        default: return "Expert";
+    }
+}
+
+// The 20 cells sharing a row, column or box with each cell.
+using PeerTable = std::array<std::array<uint8_t,20>,N*N>;
+constexpr PeerTable MakePeers() {
+    PeerTable p{};
+    for (int i=0;i<N*N;i++) {
+        int r=i/N, c=i%N, k=0;
+        for (int j=0;j<N*N;j++) {
+            int rr=j/N, cc=j%N;
+            if (j!=i && (rr==r || cc==c || BoxOf(rr,cc)==BoxOf(r,c))) p[i][k++]=uint8_t(j);
+        }
+    }
+    return p;
+}
+static constexpr PeerTable PEERS = MakePeers();
+
+// ------------------- Logical Grader -------------------
+struct LogicGrader {
+    std::array<uint8_t,N*N> cell{};
+    std::array<uint16_t,N*N> cand{};
+    int filled=0;
+
+    bool Load(const Grid &g) {
+        BitSolver s;
+        if (!s.Load(g)) return false;
+        cell=s.cell; filled=0;
+        for (int i=0;i<N*N;i++) {
+            cand[i]=cell[i] ? 0 : s.Candidates(i);
+            if (cell[i]) filled++;
+        }
+        return true;
+    }
+
+    void Place(int i,int v) {
+        uint16_t bit=uint16_t(1u<<(v-1));
+        cell[i]=uint8_t(v); cand[i]=0; filled++;
+        for (uint8_t p: PEERS[i]) cand[p]&=uint16_t(~bit);
+    }
+
+    // Each technique returns 1 on progress, 0 if it found nothing and -1
+    // when the grid is contradictory.
+    int NakedSingles() {
+        int progress=0;
+        for (int i=0;i<N*N;i++) {
+            if (cell[i]) continue;
+            if (!cand[i]) return -1;
+            if (!(cand[i]&(cand[i]-1))) { Place(i,__builtin_ctz(cand[i])+1); progress=1; }
+        }
+        return progress;
+    }
+
+    int HiddenSingles() {
+        int progress=0;
+        for (const auto &unit: UNITS) {
+            uint16_t once=0, twice=0;
+            for (uint8_t i: unit) { twice|=once&cand[i]; once|=cand[i]; }
+            for (uint16_t single=once&~twice; single; single&=single-1) {
+                uint16_t bit=single&-single;
+                for (uint8_t i: unit)
+                    if (cand[i]&bit) { Place(i,__builtin_ctz(bit)+1); progress=1; break; }
+            }
+        }
+        return progress;
+    }
+
+    // Removes `bit` from every cell of unit u that is not in `keep` (a unit
+    // of another kind). Returns whether anything changed.
+    bool EliminateOutside(int u, int keep, uint16_t bit) {
+        bool changed=false;
+        for (uint8_t i: UNITS[u]) {
+            if (std::find(UNITS[keep].begin(),UNITS[keep].end(),i)!=UNITS[keep].end()) continue;
+            if (cand[i]&bit) { cand[i]&=uint16_t(~bit); changed=true; }
+        }
+        return changed;
+    }
+
+    int LockedCandidates() {
+        bool changed=false;
+        for (int b=0;b<N;b++) for (int d=0;d<N;d++) {
+            uint16_t bit=uint16_t(1u<<d);
+            int rows=0, cols=0;
+            for (uint8_t i: UNITS[2*N+b])
+                if (cand[i]&bit) { rows|=1<<(i/N); cols|=1<<(i%N); }
+            if (!rows) continue;
+            if (!(rows&(rows-1))) changed|=EliminateOutside(__builtin_ctz(rows),2*N+b,bit);
+            if (!(cols&(cols-1))) changed|=EliminateOutside(N+__builtin_ctz(cols),2*N+b,bit);
+        }
+        for (int u=0;u<2*N;u++) for (int d=0;d<N;d++) {
+            uint16_t bit=uint16_t(1u<<d);
+            int boxes=0;
+            for (uint8_t i: UNITS[u])
+                if (cand[i]&bit) boxes|=1<<BoxOf(i/N,i%N);
+            if (boxes && !(boxes&(boxes-1))) changed|=EliminateOutside(2*N+__builtin_ctz(boxes),u,bit);
+        }
+        return changed ? 1 : 0;
+    }
+
+    int NakedSubsets() {
+        bool changed=false;
+        for (const auto &unit: UNITS) {
+            uint8_t open[N]; int n=0;
+            for (uint8_t i: unit) if (cand[i]) open[n++]=i;
+            auto clearOthers=[&](uint16_t mask, int a, int b, int c) {
+                for (int k=0;k<n;k++) {
+                    if (k==a||k==b||k==c) continue;
+                    if (cand[open[k]]&mask) { cand[open[k]]&=uint16_t(~mask); changed=true; }
+                }
+            };
+            for (int a=0;a<n;a++) for (int b=a+1;b<n;b++) {
+                uint16_t pair=cand[open[a]]|cand[open[b]];
+                if (__builtin_popcount(pair)==2) clearOthers(pair,a,b,-1);
+                for (int c=b+1;c<n;c++) {
+                    uint16_t triple=pair|cand[open[c]];
+                    if (__builtin_popcount(triple)==3) clearOthers(triple,a,b,c);
+                }
+            }
+        }
+        return changed ? 1 : 0;
+    }
+};
+
+// Grades a puzzle by the hardest technique needed to solve it logically.
+inline Difficulty GradePuzzle(const Grid &g) {
+    LogicGrader lg;
+    if (!lg.Load(g)) return Difficulty::Expert;
+    Difficulty hardest=Difficulty::Easy;
+    while (lg.filled<N*N) {
+        int step=lg.NakedSingles();
+        if (step==0) step=lg.HiddenSingles();
+        if (step==0 && (step=lg.LockedCandidates())>0) hardest=std::max(hardest,Difficulty::Medium);
+        if (step==0 && (step=lg.NakedSubsets())>0) hardest=std::max(hardest,Difficulty::Hard);
+        if (step<=0) return Difficulty::Expert;
+    }
+    return hardest;
+}
+
+// ------------------- Generator -------------------
+struct GeneratorOptions {
+    Difficulty difficulty=Difficulty::Medium;
+    int targetClues=0;      // stop removing at this many clues; 0 = remove while allowed
+    int maxAttempts=24;     // fresh solved grids to try before settling for the closest grade
+};
+
+template <int B=3>
+inline GridT<B> RandomSolvedGrid(std::mt19937 &rng) {
+    constexpr int S = B*B;
+    std::array<int,S> digits;
+    std::iota(digits.begin(),digits.end(),1);
+    for (;;) {
+        GridT<B> g{};
+        // The diagonal boxes don't constrain each other, so any shuffle fits.
+        for (int k=0;k<S;k+=B) {
+            std::shuffle(digits.begin(),digits.end(),rng);
+            for (int j=0;j<S;j++) g[k+j/B][k+j%B]=digits[j];
+        }
+        // Most fillings take a few nodes per cell, but on 16x16 and 25x25 the
+        // odd one runs for minutes; starting over is far cheaper.
+        SolveControl budget;
+        budget.nodeLimit=4*S*S;
+        if (SolveSudoku<B>(g,&budget)) return g;
+    }
+}
+
+// True if naked and hidden singles alone fill the grid: then it has exactly
+// one solution, and the solver finds it without branching.
+template <int B>
+inline bool SolvesBySingles(const GridT<B> &g) {
+    BitSolverT<B> s;
+    return s.Load(g) && s.Propagate() && s.PickCell()<0;
+}
+
+// Blanks random cells of a fresh solved grid, down to `clues` givens where
+// it can, keeping each blank only if singles still solve the grid. Used for
+// the 16x16 and 25x25 boards: a counting uniqueness check is too slow there,
+// and blanking cells blindly gives boards the solver can search for minutes.
+template <int B>
+inline GridT<B> GenerateQuickPuzzle(int clues, std::mt19937 &rng) {
+    constexpr int S = B*B;
+    GridT<B> g=RandomSolvedGrid<B>(rng);
+    std::array<int,S*S> order;
+    std::iota(order.begin(),order.end(),0);
+    std::shuffle(order.begin(),order.end(),rng);
+    int left=S*S;
+    for (int idx: order) {
+        if (left<=clues) break;
+        int r=idx/S, c=idx%S, v=g[r][c];
+        g[r][c]=0;
+        if (SolvesBySingles<B>(g)) left--;
+        else g[r][c]=v;
+    }
+    return g;
+}
+
+// Removes clues in random order, each cell at most once, keeping only
+// removals that leave a unique solution no harder than the target.
+inline Grid GeneratePuzzle(const GeneratorOptions &opt, std::mt19937 &rng, Difficulty *grade=nullptr) {
+    std::array<int,N*N> order;
+    std::iota(order.begin(),order.end(),0);
+    Grid best{};
+    Difficulty bestGrade=Difficulty::Easy;
+    bool haveBest=false;
+    for (int attempt=0;attempt<std::max(1,opt.maxAttempts);attempt++) {
+        Grid g=RandomSolvedGrid(rng);
+        int clues=N*N;
+        std::shuffle(order.begin(),order.end(),rng);
+        for (int idx: order) {
+            if (clues<=opt.targetClues) break;
+            int r=idx/N, c=idx%N, v=g[r][c];
+            g[r][c]=0;
+            if (HasUniqueSolution(g) && GradePuzzle(g)<=opt.difficulty) clues--;
+            else g[r][c]=v;
+        }
+        Difficulty got=GradePuzzle(g);
+        if (!haveBest || got>bestGrade) { best=g; bestGrade=got; haveBest=true; }
+        if (got==opt.difficulty) break;
+    }
+    if (grade) *grade=bestGrade;
+    return best;
+}
+
+// ------------------- Puzzle Pool -------------------
+template <typename T, size_t Cap>
+class RingBuffer {
+public:
+    bool Push(const T &v) {
+        if (count==Cap) return false;
+        items[(head+count)%Cap]=v; count++;
+        return true;
+    }
+    bool Pop(T &out) {
+        if (count==0) return false;
+        out=items[head]; head=(head+1)%Cap; count--;
+        return true;
+    }
+    size_t Size() const { return count; }
+    bool Full() const { return count==Cap; }
+private:
+    std::array<T,Cap> items{};
+    size_t head=0, count=0;
+};
+
+// A background thread keeps a few puzzles of every difficulty ready, always
+// topping up the emptiest ring first, so taking one is an O(1) pop.
+class PuzzlePool {
+public:
+    static constexpr size_t CAPACITY = 8;
+
+    explicit PuzzlePool(unsigned seed=std::random_device{}()) : rng(seed), worker([this]{ Run(); }) {}
+
+    ~PuzzlePool() {
+        { std::lock_guard<std::mutex> lk(m); stopping=true; }
+        cv.notify_all();
+        worker.join();
+    }
+
+    bool TryPop(Difficulty d, Grid &out) {
+        bool ok;
+        { std::lock_guard<std::mutex> lk(m); ok=rings[(int)d].Pop(out); }
+        if (ok) cv.notify_one();
+        return ok;
+    }
+
+    size_t Ready(Difficulty d) {
+        std::lock_guard<std::mutex> lk(m);
+        return rings[(int)d].Size();
+    }
+
+private:
+    void Run() {
+        for (;;) {
+            int target=0;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                cv.wait(lk,[this]{ return stopping || !AllFull(); });
+                if (stopping) return;
+                for (int d=1;d<DIFFICULTY_COUNT;d++)
+                    if (rings[d].Size()<rings[target].Size()) target=d;
+            }
+            GeneratorOptions opt;
+            opt.difficulty=(Difficulty)target;
+            Difficulty got;
+            Grid g=GeneratePuzzle(opt,rng,&got);
+            std::lock_guard<std::mutex> lk(m);
+            rings[(int)got].Push(g);
+        }
+    }
+
+    bool AllFull() const {
+        for (const auto &r: rings) if (!r.Full()) return false;
+        return true;
+    }
+
+    std::array<RingBuffer<Grid,CAPACITY>,DIFFICULTY_COUNT> rings;
+    std::mutex m;
+    std::condition_variable cv;
+    bool stopping=false;
+    std::mt19937 rng;
+    std::thread worker;
+};
@@ -0,0 +1,119 @@
+// Search tracing: an instrumented solve that records every placement and
+// backtrack into a fixed ring buffer, for animated replay and export.
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "SudokuCore.h"
+
+// ------------------- Trace Records -------------------
+// One record is 16 bits: cell (7) | value (4) | op (2).
+enum class TraceOp : uint8_t { Force, Guess, Undo };
+
+inline uint16_t PackTrace(int cell, int value, TraceOp op) {
+    return uint16_t(cell | (value<<7) | (int(op)<<11));
+}
+inline int TraceCell(uint16_t rec) { return rec&0x7F; }
+inline int TraceValue(uint16_t rec) { return (rec>>7)&0xF; }
+inline TraceOp TraceOpOf(uint16_t rec) { return TraceOp((rec>>11)&0x3); }
+
+// Fixed-capacity ring of records. Once full, the oldest record is folded
+// into `base`, so `base` followed by the retained records always replays to
+// the current search state.
+class SolveTrace {
+public:
+    explicit SolveTrace(size_t capacity=1<<20) : ring(capacity ? capacity : 1) {}
+
+    void Begin(const Grid &start) {
+        base=start; head=0; count=0; total=0; guesses=0; undos=0;
+    }
+
+    void Push(int cell, int value, TraceOp op) {
+        if (op==TraceOp::Guess) guesses++;
+        else if (op==TraceOp::Undo) undos++;
+        total++;
+        if (count==ring.size()) {
+            Apply(base,ring[head]);
+            ring[head]=PackTrace(cell,value,op);
+            head=(head+1)%ring.size();
+        } else ring[(head+count++)%ring.size()]=PackTrace(cell,value,op);
+    }
+
+    static void Apply(Grid &g, uint16_t rec) {
+        int cell=TraceCell(rec);
+        g[cell/N][cell%N]=TraceOpOf(rec)==TraceOp::Undo ? 0 : TraceValue(rec);
+    }
+
+    size_t Size() const { return count; }
+    uint16_t At(size_t i) const { return ring[(head+i)%ring.size()]; }
+    const Grid &Base() const { return base; }
+    uint64_t Total() const { return total; }
+    uint64_t Dropped() const { return total-count; }
+    uint64_t Guesses() const { return guesses; }
+    uint64_t Undos() const { return undos; }
+
+    // Binary layout (little-endian):
+    //   "SDKT" | u32 version | u64 total | u64 dropped | u64 guesses | u64 undos
+    //   | u64 retained | 81 bytes base grid | retained x u16 records
+    bool Export(const std::string &path) const {
+        FILE *f=std::fopen(path.c_str(),"wb");
+        if (!f) return false;
+        auto put=[&](uint64_t v,int bytes) {
+            for (int i=0;i<bytes;i++) std::fputc(int((v>>(8*i))&0xFF),f);
+        };
+        std::fwrite("SDKT",1,4,f);
+        put(1,4); put(total,8); put(Dropped(),8); put(guesses,8); put(undos,8); put(count,8);
+        for (int r=0;r<N;r++) for (int c=0;c<N;c++) std::fputc(base[r][c],f);
+        for (size_t i=0;i<count;i++) put(At(i),2);
+        return std::fclose(f)==0;
+    }
+
+private:
+    std::vector<uint16_t> ring;
+    Grid base{};
+    size_t head=0, count=0;
+    uint64_t total=0, guesses=0, undos=0;
+};
+
+// ------------------- Traced Solve -------------------
+// Same search as BitSolver::Search, but every forced placement, guess and
+// undo is recorded so a replay walks the exact search tree.
+inline void TraceForced(const BitSolver &before, const BitSolver &after, SolveTrace &trace, TraceOp op) {
+    for (int i=0;i<N*N;i++)
+        if (!before.cell[i] && after.cell[i]) trace.Push(i,after.cell[i],op);
+}
+
+inline bool TracedSearch(BitSolver &s, SolveTrace &trace, SolveControl *control, int depth) {
+    if (control) {
+        if (control->Cancelled()) return false;
+        control->Visit(depth);
+    }
+    BitSolver before=s;
+    bool ok=s.Propagate();
+    TraceForced(before,s,trace,TraceOp::Force);
+    if (ok) {
+        int best=s.PickCell();
+        if (best<0) return true;
+        for (uint16_t cand=s.Candidates(best); cand; cand&=cand-1) {
+            int v=__builtin_ctz(cand)+1;
+            BitSolver next=s;
+            next.Place(best,v);
+            trace.Push(best,v,TraceOp::Guess);
+            if (TracedSearch(next,trace,control,depth+1)) { s=next; return true; }
+            trace.Push(best,0,TraceOp::Undo);
+            if (control && control->Cancelled()) break;
+        }
+    }
+    for (int i=0;i<N*N;i++)
+        if (!before.cell[i] && s.cell[i]) trace.Push(i,0,TraceOp::Undo);
+    s=before;
+    return false;
+}
+
+inline bool SolveSudokuTraced(Grid &g, SolveTrace &trace, SolveControl *control=nullptr) {
+    trace.Begin(g);
+    BitSolver s;
+    if (!s.Load(g) || !TracedSearch(s,trace,control,0)) return false;
+    s.Store(g);
+    return true;
+}
@@ -0,0 +1,219 @@
+// Whole-grid conflict detection over a packed grid, with SSE2/AVX2 kernels
+// and a scalar fallback (used on non-x86 targets such as Apple Silicon).
+#pragma once
+#include <array>
+#include <cstdint>
+#include "SudokuCore.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SUDOKU_SSE2 1
+#endif
+
+// ------------------- Packed Grid -------------------
+// One byte per cell, each row padded to 16 bytes so a row is one SSE lane
+// and two rows are one AVX2 lane. The tenth row is padding (always zero).
+struct alignas(32) PackedGrid {
+    static constexpr int STRIDE = 16;
+    std::array<uint8_t,(N+1)*STRIDE> cells{};
+
+    uint8_t Get(int r,int c) const { return cells[r*STRIDE+c]; }
+    void Set(int r,int c,int v) { cells[r*STRIDE+c]=uint8_t(v); }
+};
+
+inline PackedGrid PackGrid(const Grid &g) {
+    PackedGrid p;
+    for (int r=0;r<N;r++) for (int c=0;c<N;c++) p.Set(r,c,g[r][c]);
+    return p;
+}
+
+// ------------------- Conflict Map -------------------
+// rows[r] has bit c set when cell (r,c) repeats a digit in its row, column
+// or box. `full` means no empty cell; `valid` means no conflicts at all.
+template <int B=3>
+struct ConflictMapT {
+    std::array<typename Dims<B>::Mask,B*B> rows{};
+    bool full=false, valid=false;
+
+    bool At(int r,int c) const { return (rows[r]>>c)&1; }
+    bool Solved() const { return full && valid; }
+};
+
+// The packed-grid kernels below are specialised for 9x9.
+using ConflictMap = ConflictMapT<3>;
+
+// Per-row column masks of the cells holding digit v: m[r] bit c <=> g[r][c]==v.
+inline void DigitMasksScalar(const PackedGrid &p, uint8_t v, std::array<uint16_t,N> &m) {
+    for (int r=0;r<N;r++) {
+        uint16_t bits=0;
+        for (int c=0;c<N;c++) bits|=uint16_t((p.Get(r,c)==v)<<c);
+        m[r]=bits;
+    }
+}
+
+#if defined(__AVX2__)
+inline void DigitMasks(const PackedGrid &p, uint8_t v, std::array<uint16_t,N> &m) {
+    const __m256i needle=_mm256_set1_epi8((char)v);
+    for (int r=0;r<N;r+=2) {
+        __m256i pair=_mm256_load_si256((const __m256i*)&p.cells[r*PackedGrid::STRIDE]);
+        uint32_t bits=(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(pair,needle));
+        m[r]=uint16_t(bits&ALL_DIGITS);
+        if (r+1<N) m[r+1]=uint16_t((bits>>16)&ALL_DIGITS);
+    }
+}
+#elif defined(SUDOKU_SSE2)
+inline void DigitMasks(const PackedGrid &p, uint8_t v, std::array<uint16_t,N> &m) {
+    const __m128i needle=_mm_set1_epi8((char)v);
+    for (int r=0;r<N;r++) {
+        __m128i row=_mm_load_si128((const __m128i*)&p.cells[r*PackedGrid::STRIDE]);
+        m[r]=uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(row,needle))&ALL_DIGITS);
+    }
+}
+#else
+inline void DigitMasks(const PackedGrid &p, uint8_t v, std::array<uint16_t,N> &m) {
+    DigitMasksScalar(p,v,m);
+}
+#endif
+
+// Folds the digit masks of one value into the conflict map: a row, column
+// or box holding the digit more than once marks all of its copies.
+inline void AccumulateConflicts(const std::array<uint16_t,N> &m, ConflictMap &out) {
+    uint16_t seen=0, dupCols=0;
+    for (int r=0;r<N;r++) {
+        if (m[r]&(m[r]-1)) out.rows[r]|=m[r];
+        dupCols|=seen&m[r]; seen|=m[r];
+    }
+    for (int r=0;r<N;r++) out.rows[r]|=m[r]&dupCols;
+    for (int br=0;br<N;br+=BOX)
+        for (int bc=0;bc<N;bc+=BOX) {
+            uint16_t boxCols=uint16_t(((1u<<BOX)-1)<<bc);
+            // Gather the box's three row slices into one 9-bit mask.
+            uint16_t box=0;
+            for (int k=0;k<BOX;k++) box|=uint16_t(((m[br+k]&boxCols)>>bc)<<(k*BOX));
+            if (box&(box-1))
+                for (int r=br;r<br+BOX;r++) out.rows[r]|=m[r]&boxCols;
+        }
+}
+
+template <typename MaskFn>
+inline ConflictMap ComputeConflictsWith(const PackedGrid &p, MaskFn masks) {
+    ConflictMap out;
+    std::array<uint16_t,N> m;
+    masks(p,0,m);
+    out.full=true;
+    for (int r=0;r<N;r++) if (m[r]) out.full=false;
+    for (int v=1;v<=N;v++) {
+        masks(p,uint8_t(v),m);
+        AccumulateConflicts(m,out);
+    }
+    out.valid=true;
+    for (uint16_t row: out.rows) if (row) out.valid=false;
+    return out;
+}
+
+inline ConflictMap ComputeConflicts(const PackedGrid &p) {
+    return ComputeConflictsWith(p,[](const PackedGrid &g, uint8_t v, std::array<uint16_t,N> &m) { DigitMasks(g,v,m); });
+}
+inline ConflictMap ComputeConflictsScalar(const PackedGrid &p) {
+    return ComputeConflictsWith(p,[](const PackedGrid &g, uint8_t v, std::array<uint16_t,N> &m) { DigitMasksScalar(g,v,m); });
+}
+inline ConflictMap ComputeConflicts(const Grid &g) { return ComputeConflicts(PackGrid(g)); }
+
+// True when `solved` is complete, conflict-free and keeps every given of `puzzle`.
+inline bool IsValidSolution(const Grid &puzzle, const Grid &solved) {
+    for (int r=0;r<N;r++) for (int c=0;c<N;c++)
+        if (puzzle[r][c] && puzzle[r][c]!=solved[r][c]) return false;
+    return ComputeConflicts(solved).Solved();
+}
+
+// ------------------- Incremental Tracking -------------------
+// Keeps per-unit digit counts for a grid that changes one cell at a time,
+// so full/valid never need a rescan. An edit can only change the conflicts
+// of cells sharing a unit with it, so it refreshes those bits: O(S) per
+// edit, and Map() is free.
+template <int B=3>
+class ConflictTrackerT {
+public:
+    using D = Dims<B>;
+    static constexpr int S = D::SIDE;
+
+    void Reset(const GridT<B> &g) {
+        *this=ConflictTrackerT{};
+        for (int r=0;r<S;r++) for (int c=0;c<S;c++) Add(r,c,g[r][c]);
+        values=g;
+        for (int r=0;r<S;r++) for (int c=0;c<S;c++) SetBit(r,c);
+        SetFlags();
+    }
+
+    void Update(int r,int c,int v) {
+        int old=values[r][c];
+        if (old==v) return;
+        Remove(r,c,old);
+        Add(r,c,v);
+        values[r][c]=v;
+        int br=r/B*B, bc=c/B*B;
+        for (int i=0;i<S;i++) { SetBit(r,i); SetBit(i,c); SetBit(br+i/B,bc+i%B); }
+        SetFlags();
+    }
+
+    bool IsFull() const { return filled==D::CELLS; }
+    bool IsValid() const { return duplicates==0; }
+    bool IsSolved() const { return IsFull() && IsValid(); }
+
+    bool HasConflictAt(int r,int c) const {
+        int v=values[r][c];
+        return v && (rowCount[r][v]>1 || colCount[c][v]>1 || boxCount[D::BoxOf(r,c)][v]>1);
+    }
+
+    const ConflictMapT<B> &Map() const { return map; }
+
+private:
+    using Counts = std::array<std::array<uint8_t,S+1>,S>;
+
+    // Adjusts one unit's count for v, tracking how many (unit, digit) pairs
+    // currently hold duplicates.
+    void Bump(uint8_t &count, int delta) {
+        if (delta>0 && ++count==2) duplicates++;
+        else if (delta<0 && count--==2) duplicates--;
+    }
+
+    void Add(int r,int c,int v) {
+        if (!v) return;
+        Bump(rowCount[r][v],1); Bump(colCount[c][v],1); Bump(boxCount[D::BoxOf(r,c)][v],1);
+        filled++;
+    }
+
+    void Remove(int r,int c,int v) {
+        if (!v) return;
+        Bump(rowCount[r][v],-1); Bump(colCount[c][v],-1); Bump(boxCount[D::BoxOf(r,c)][v],-1);
+        filled--;
+    }
+
+    void SetBit(int r,int c) {
+        typename D::Mask bit=typename D::Mask(1u<<c);
+        if (HasConflictAt(r,c)) map.rows[r]|=bit;
+        else map.rows[r]&=typename D::Mask(~bit);
+    }
+
+    void SetFlags() { map.full=IsFull(); map.valid=IsValid(); }
+
+    GridT<B> values{};
+    Counts rowCount{}, colCount{}, boxCount{};
+    int filled=0, duplicates=0;
+    ConflictMapT<B> map;
+};
+
+using ConflictTracker = ConflictTrackerT<3>;
+
+// IsValidSolution() for any board size; call as IsValidSolution<B>(...).
+template <int B>
+inline bool IsValidSolution(const GridT<B> &puzzle, const GridT<B> &solved) {
+    constexpr int S = B*B;
+    if constexpr (B==3) return IsValidSolution(puzzle,solved);
+    for (int r=0;r<S;r++) for (int c=0;c<S;c++)
+        if (puzzle[r][c] && puzzle[r][c]!=solved[r][c]) return false;
+    ConflictTrackerT<B> t;
+    t.Reset(solved);
+    return t.IsSolved();
+}